@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    BlockBenchmark.cpp
+    Created: 17 Oct 2026 2:21:48pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "BlockBenchmark.h"
+#include "../../BasicSynthPlugin/Source/PluginProcessor.h"
+
+//==============================================================================
+BlockBenchmark::Result BlockBenchmark::run (const Case& testCase, double secondsOfAudio)
+{
+    BasicSynthAudioProcessor processor;
+    const int numChannels = processor.getTotalNumOutputChannels();
+
+    auto state = std::make_unique<SynthState> (processor.getRequestedState());
+    state->polyphony = testCase.numVoices;
+    state->voiceType = testCase.voiceType;
+    processor.queueState (std::move (state));
+
+    processor.setPlayConfigDetails (0, numChannels, testCase.sampleRate, testCase.blockSize);
+    processor.prepareToPlay (testCase.sampleRate, testCase.blockSize);
+
+    AudioBuffer<float> buffer (numChannels, testCase.blockSize);
+    MidiBuffer midi;
+
+    // held notes, so every voice is sounding for the whole run. Each one is a different
+    // channel and note pair, a repeated one would stop the voice already playing it.
+    for (int i = 0; i < testCase.numVoices; ++i)
+        midi.addEvent (MidiMessage::noteOn (1 + (i / 96) % 16, 24 + i % 96, 0.5f), 0);
+
+    processor.processBlock (buffer, midi);
+    midi.clear();
+
+    // let the attacks settle and the caches warm up before timing anything
+    const int numWarmUpBlocks = jmax (8, (int) (0.1 * testCase.sampleRate) / testCase.blockSize);
+
+    for (int i = 0; i < numWarmUpBlocks; ++i)
+        processor.processBlock (buffer, midi);
+
+    const int numBlocks = jmax (16, (int) (secondsOfAudio * testCase.sampleRate) / testCase.blockSize);
+    std::vector<int64> ticks ((size_t) numBlocks);
+
+    for (auto& t : ticks)
+    {
+        const int64 start = Time::getHighResolutionTicks();
+        processor.processBlock (buffer, midi);
+        t = Time::getHighResolutionTicks() - start;
+    }
+
+    processor.releaseResources();
+
+    std::sort (ticks.begin(), ticks.end());
+
+    const double nsPerTick = 1.0e9 / (double) Time::getHighResolutionTicksPerSecond();
+    const auto percentile = [&ticks, nsPerTick] (int percent)
+    {
+        const size_t index = jmin (ticks.size() - 1, ticks.size() * (size_t) percent / 100);
+        return (double) ticks[index] * nsPerTick;
+    };
+
+    int64 totalTicks = 0;
+
+    for (auto t : ticks)
+        totalTicks += t;
+
+    Result result;
+    result.testCase = testCase;
+    result.numBlocks = numBlocks;
+    result.meanNs = (double) totalTicks * nsPerTick / numBlocks;
+    result.p50Ns = percentile (50);
+    result.p99Ns = percentile (99);
+    result.maxNs = (double) ticks.back() * nsPerTick;
+    result.realtimeRatio = result.meanNs * 1.0e-9 / (testCase.blockSize / testCase.sampleRate);
+
+    return result;
+}
@@ -0,0 +1,43 @@
+/*
+  ==============================================================================
+
+    BlockBenchmark.h
+    Created: 17 Oct 2026 2:21:48pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Times BasicSynthAudioProcessor::processBlock for one block size, sample rate
+    and voice count, without a host or audio device.
+*/
+class BlockBenchmark
+{
+public:
+    struct Case
+    {
+        double sampleRate = 48000.0;
+        int blockSize = 512;
+        int numVoices = 8;
+        int voiceType = 0;      // VoiceBank::VoiceType
+    };
+
+    struct Result
+    {
+        Case testCase;
+        int numBlocks = 0;
+        double meanNs = 0.0;
+        double p50Ns = 0.0;
+        double p99Ns = 0.0;
+        double maxNs = 0.0;
+        double realtimeRatio = 0.0;   // processing time / audio time, above 1.0 can't keep up
+    };
+
+    /** Holds numVoices notes for secondsOfAudio and times every block after a short warm up. */
+    static Result run (const Case& testCase, double secondsOfAudio);
+};
@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    This file was auto-generated!
+
+    It contains the basic startup code for a JUCE application.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "BlockBenchmark.h"
+#include "../../BasicSynthPlugin/Source/VoiceBank.h"
+
+//==============================================================================
+static Array<int> parseList (const ArgumentList& args, const char* option, const Array<int>& defaultValues)
+{
+    if (! args.containsOption (option))
+        return defaultValues;
+
+    Array<int> values;
+
+    for (auto& item : StringArray::fromTokens (args.getValueForOption (option), ",", {}))
+        if (item.getIntValue() > 0)
+            values.add (item.getIntValue());
+
+    return values;
+}
+
+int main (int argc, char* argv[])
+{
+    ScopedJuceInitialiser_GUI juceInitialiser;
+    ArgumentList args (argc, argv);
+
+    if (args.containsOption ("--help|-h"))
+    {
+        std::cout << "Times BasicSynth's processBlock over a matrix of block sizes, sample rates and voice counts." << std::endl
+                  << std::endl
+                  << "  --blocks=32,64,...      block sizes (32 to 2048)" << std::endl
+                  << "  --rates=44100,48000,... sample rates (44100,48000,96000)" << std::endl
+                  << "  --voices=1,8,...        voices held during the run (1,8,32,128)" << std::endl
+                  << "  --seconds=<n>           audio rendered per case (10)" << std::endl
+                  << "  --fm                    play the six operator FM voice instead of the sine" << std::endl
+                  << "  --csv                   print comma separated values instead of a table" << std::endl;
+        return 0;
+    }
+
+    const auto blockSizes = parseList (args, "--blocks", { 32, 64, 128, 256, 512, 1024, 2048 });
+    const auto sampleRates = parseList (args, "--rates", { 44100, 48000, 96000 });
+    const auto voiceCounts = parseList (args, "--voices", { 1, 8, 32, 128 });
+    const bool csv = args.containsOption ("--csv");
+    const int voiceType = args.containsOption ("--fm") ? (int) VoiceBank::fmVoice : (int) VoiceBank::sineVoice;
+
+    double seconds = 10.0;
+
+    if (args.containsOption ("--seconds"))
+        seconds = jmax (0.1, args.getValueForOption ("--seconds").getDoubleValue());
+
+    if (csv)
+        std::cout << "rate,block,voices,blocks,mean_ns,p50_ns,p99_ns,max_ns,rt_ratio" << std::endl;
+    else
+        std::cout << "  rate  block voices   blocks     mean ns      p50 ns      p99 ns      max ns   rt ratio" << std::endl;
+
+    for (auto rate : sampleRates)
+    {
+        for (auto blockSize : blockSizes)
+        {
+            for (auto numVoices : voiceCounts)
+            {
+                BlockBenchmark::Case testCase;
+                testCase.sampleRate = (double) rate;
+                testCase.blockSize = blockSize;
+                testCase.numVoices = numVoices;
+                testCase.voiceType = voiceType;
+
+                const auto r = BlockBenchmark::run (testCase, seconds);
+
+                if (csv)
+                {
+                    std::cout << rate << "," << blockSize << "," << numVoices << "," << r.numBlocks << ","
+                              << String (r.meanNs, 0) << "," << String (r.p50Ns, 0) << ","
+                              << String (r.p99Ns, 0) << "," << String (r.maxNs, 0) << ","
+                              << String (r.realtimeRatio, 5) << std::endl;
+                }
+                else
+                {
+                    std::cout << String (rate).paddedLeft (' ', 6)
+                              << String (blockSize).paddedLeft (' ', 7)
+                              << String (numVoices).paddedLeft (' ', 7)
+                              << String (r.numBlocks).paddedLeft (' ', 9)
+                              << String (r.meanNs, 0).paddedLeft (' ', 12)
+                              << String (r.p50Ns, 0).paddedLeft (' ', 12)
+                              << String (r.p99Ns, 0).paddedLeft (' ', 12)
+                              << String (r.maxNs, 0).paddedLeft (' ', 12)
+                              << String (r.realtimeRatio, 5).paddedLeft (' ', 11) << std::endl;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
@@ -607,10 +607,13 @@ void fft::calcIFFT(int start, float *finalOut, float *window) {
 }
 
 void fft::inverseFFTComplex(int start, float *finalOut, float *window, float *real, float *imaginary) {
+    //calcIFFT transforms in_real/in_img, same layout as polToCart leaves them
     for(int i=0; i < half; i++) {
-        out_real[i] = real[i];
-        out_img[i] = imaginary[i];
+        in_real[i] = real[i];
+        in_img[i] = imaginary[i];
     }
+    memset(&in_real[0]+half, 0.0, sizeof(float) * half);
+    memset(&in_img[0]+half, 0.0, sizeof(float) * half);
     calcIFFT(start, finalOut, window);
 }
 
@@ -0,0 +1,130 @@
+//
+//  maxiAdditive.cpp
+//  Maximilian
+//
+//  Created by Chris on 17/10/2026.
+//
+
+#include "maxiAdditive.h"
+using namespace std;
+
+maxiAdditiveOsc::maxiAdditiveOsc() {
+	setup();
+}
+
+void maxiAdditiveOsc::setup(int fftSizeIn, int overlap) {
+	fftSize = fftSizeIn;
+	hopSize = fftSize / std::max(overlap, 3);
+	pos = hopSize;
+	const int half = fftSize / 2;
+
+	transform.setup(fftSize);
+	buffer.assign(fftSize, 0.f);
+	real.assign(half, 0.f);
+	imaginary.assign(half, 0.f);
+
+	//periodic Hann, which overlap-adds to a constant. Squared, as the kernel below is Hann windowed
+	//too, it sums to 3/8 per frame covering a sample.
+	window.resize(fftSize);
+	const double gain = (double) hopSize / fftSize * 8.0 / 3.0;
+	for (int i = 0; i < fftSize; i++) {
+		window[i] = (float) ((0.5 - 0.5 * cos(TWOPI * i / fftSize)) * gain);
+	}
+
+	//The spectrum of a periodic Hann window centred on the frame, as a function of the distance
+	//from the partial in bins. It's real, and the inverse transform divides by fftSize, which
+	//leaves a sine of the partial's amplitude under the window.
+	kernelTable.resize(kernelHalfWidth * kernelOversampling + 2);
+	auto dirichlet = [this](double u) {
+		const double d = sin(PI * u / fftSize);
+		return fabs(d) < 1e-12 ? fftSize - 1.0 : sin(PI * u * (fftSize - 1) / fftSize) / d;
+	};
+	for (int i = 0; i < (int) kernelTable.size(); i++) {
+		const double u = (double) i / kernelOversampling;
+		kernelTable[i] = (float) (0.5 * dirichlet(u) + 0.25 * dirichlet(u - 1) + 0.25 * dirichlet(u + 1));
+	}
+
+	//the first transform allocates the fft's shared bit reversal tables, do it here rather than on the audio thread
+	std::vector<float> scratch(fftSize, 0.f);
+	transform.inverseFFTComplex(0, &scratch[0], &window[0], &real[0], &imaginary[0]);
+}
+
+void maxiAdditiveOsc::setNumPartials(int numPartials) {
+	frequency.resize(numPartials, 0.0);
+	amplitude.resize(numPartials, 0.0);
+	phase.resize(numPartials, 0.0);
+}
+
+void maxiAdditiveOsc::phaseReset(double phaseIn) {
+	std::fill(phase.begin(), phase.end(), phaseIn - floor(phaseIn));
+}
+
+float maxiAdditiveOsc::kernel(double offset) const {
+	const double x = fabs(offset) * kernelOversampling;
+	const int index = (int) x;
+	const float remainder = (float) (x - index);
+	return kernelTable[index] + (kernelTable[index + 1] - kernelTable[index]) * remainder;
+}
+
+void maxiAdditiveOsc::nextFrame() {
+	const int half = fftSize / 2;
+	const double binsPerHz = fftSize * context->sampleDuration;
+	const double cyclesPerHz = hopSize * context->sampleDuration;
+	const double nyquist = context->nyquist;
+
+	std::fill(real.begin(), real.end(), 0.f);
+	std::fill(imaginary.begin(), imaginary.end(), 0.f);
+
+	for (int p = 0; p < (int) frequency.size(); p++) {
+		const double f = frequency[p];
+		if (amplitude[p] != 0 && f > 0 && f < nyquist) {
+			const double centre = f * binsPerHz;
+			//this fft's inverse turns the opposite way to the usual one, so the phase goes in conjugated
+			const float re = (float) (amplitude[p] * cos(TWOPI * phase[p]));
+			const float im = (float) (-amplitude[p] * sin(TWOPI * phase[p]));
+			const int first = (int) ceil(centre - kernelHalfWidth);
+			const int last = (int) floor(centre + kernelHalfWidth);
+
+			for (int k = first; k <= last; k++) {
+				//the window is centred on the frame, which turns every other bin upside down
+				const float s = (k & 1) ? -kernel(k - centre) : kernel(k - centre);
+
+				//bins below 0 and above Nyquist are the same as their mirror images conjugated,
+				//the real part of the inverse transform can't tell them apart
+				if (k < 0) {
+					real[-k] += re * s;
+					imaginary[-k] -= im * s;
+				} else if (k < half) {
+					real[k] += re * s;
+					imaginary[k] += im * s;
+				} else if (k > half) {
+					real[fftSize - k] += re * s;
+					imaginary[fftSize - k] -= im * s;
+				}
+			}
+		}
+		phase[p] += f * cyclesPerHz;
+		phase[p] -= floor(phase[p]);
+	}
+
+	//shift back by one hop, clear the end and add the new frame
+	memmove(&buffer[0], &buffer[0] + hopSize, (fftSize - hopSize) * sizeof(float));
+	memset(&buffer[0] + (fftSize - hopSize), 0, hopSize * sizeof(float));
+	transform.inverseFFTComplex(0, &buffer[0], &window[0], &real[0], &imaginary[0]);
+	pos = 0;
+}
+
+double maxiAdditiveOsc::play() {
+	if (pos == hopSize) nextFrame();
+	return buffer[pos++];
+}
+
+void maxiAdditiveOsc::play(float *output, int numSamples) {
+	for (int i = 0; i < numSamples;) {
+		if (pos == hopSize) nextFrame();
+		const int count = std::min(numSamples - i, hopSize - pos);
+		std::copy(&buffer[pos], &buffer[pos] + count, output + i);
+		pos += count;
+		i += count;
+	}
+}
@@ -0,0 +1,75 @@
+//
+//  maxiAdditive.h
+//  Maximilian
+//
+//  Created by Chris on 17/10/2026.
+//
+//  Additive oscillator that renders its partials with an inverse FFT and overlap-add, so the
+//  cost per sample depends on the frame rate rather than on how many partials there are.
+
+#ifndef maxiAdditive_h
+#define maxiAdditive_h
+
+#include "maximilian.h"
+#include "fft.h"
+
+/*
+ Any number of sine partials, each with its own frequency, amplitude and phase. Once per hop every
+ partial adds the spectrum of a Hann windowed sine (a few bins either side of its frequency) to
+ one frame, the frame goes through fft::inverseFFTComplex and is overlap-added with a second Hann
+ window. Each partial's phase carries on from frame to frame, so steady partials come out as
+ clean sines and changing ones are interpolated across the overlap.
+
+ Changes to the partials are heard from the next frame on, and a frame is centred fftSize / 2
+ samples after it is made, so there is up to fftSize / 2 + hopSize samples of latency. Partials
+ closer together than about two bins (2 * sampleRate / fftSize Hz) start to blur together. The
+ error is around -70dB, except within a few bins of Nyquist, where the Nyquist bin itself is lost.
+ usage:
+
+ maxiAdditiveOsc additive;
+ additive.setup(1024, 4);
+ additive.setNumPartials(200);
+ for (int i = 0; i < 200; i++) additive.setPartial(i, 110 * (i + 1), 0.2 / (i + 1));
+
+ additive.play(buffer, numSamples);
+
+ */
+class maxiAdditiveOsc : public maxiContextUser {
+public:
+	maxiAdditiveOsc();
+
+	//fftSize a power of two, overlap the number of frames covering each sample, at least 3.
+	//Allocates, so call it before playback starts.
+	void setup(int fftSize = 1024, int overlap = 4);
+
+	//allocates when the count grows, new partials start silent with a phase of 0
+	void setNumPartials(int numPartials);
+	int getNumPartials() const { return (int) frequency.size(); }
+
+	//frequency in Hz, amplitude is the peak of the partial's sine. Partials outside 0 to Nyquist are skipped.
+	void setPartial(int index, double frequencyIn, double amplitudeIn) {
+		frequency[index] = frequencyIn;
+		amplitude[index] = amplitudeIn;
+	}
+
+	//phase in cycles at the centre of the next frame, for resynthesising analysed phases
+	void setPartialPhase(int index, double phaseIn) { phase[index] = phaseIn - floor(phaseIn); }
+	void phaseReset(double phaseIn);
+
+	double play();
+	void play(float *output, int numSamples);
+
+private:
+	void nextFrame();
+	float kernel(double offset) const;
+
+	static const int kernelHalfWidth = 6;       //bins either side of a partial
+	static const int kernelOversampling = 128;  //table points per bin
+
+	int fftSize, hopSize, pos;
+	fft transform;
+	std::vector<float> window, buffer, real, imaginary, kernelTable;
+	std::vector<double> frequency, amplitude, phase;
+};
+
+#endif
@@ -0,0 +1,76 @@
+//
+//  maxiContext.h
+//  Maximilian
+//
+//  Created by Chris on 17/10/2026.
+//
+//  Kept apart from maximilian.h so hosts can hold a context without pulling in the whole library.
+
+#ifndef maxiContext_h
+#define maxiContext_h
+
+/*
+ The sample rate and buffer settings a set of ugens runs at, with the constants derived from them
+ worked out once so the ugens can multiply rather than divide. Each ugen binds to a context when
+ it's made, the default one unless told otherwise, so two hosts (or two plugin instances in one
+ process) running at different rates each keep their own. A context must outlive the ugens bound
+ to it, and changing it is only safe while they aren't playing. Ugens work out what they derive
+ from the rate (envelope times, filter coefficients) again when setContext is called, so after
+ calling setup on a context that's already in use, call setContext on its ugens again.
+ usage:
+
+ maxiContext context;
+ context.setup(48000, 2, 512);
+ maxiOsc osc;
+ osc.setContext(context);
+
+ */
+class maxiContext {
+public:
+	maxiContext(double sampleRate = 44100, int channels = 2, int bufferSize = 1024) {
+		setup(sampleRate, channels, bufferSize);
+	}
+
+	void setup(double sampleRateIn, int channelsIn, int bufferSizeIn) {
+		sampleRate = sampleRateIn;
+		channels = channelsIn;
+		bufferSize = bufferSizeIn;
+		sampleDuration = 1.0 / sampleRate;
+		nyquist = sampleRate * 0.5;
+		samplesPerMs = sampleRate * 0.001;
+		radiansPerHz = 6.283185307179586476925286766559 / sampleRate;
+	}
+
+	//set by setup, read only
+	double sampleRate;
+	int channels;
+	int bufferSize;
+	double sampleDuration;  //seconds per sample
+	double nyquist;         //in Hz
+	double samplesPerMs;
+	double radiansPerHz;    //phase change per sample of one Hz
+
+	//what ugens bind to unless they are given another, kept in step with maxiSettings
+	static maxiContext &getDefault() {
+		static maxiContext defaultContext;
+		return defaultContext;
+	}
+};
+
+//base for ugens that depend on the sample rate
+class maxiContextUser {
+public:
+	void setContext(const maxiContext &newContext) {
+		context = &newContext;
+		contextChanged();
+	}
+	const maxiContext &getContext() const { return *context; }
+
+protected:
+	//ugens that keep values worked out from the rate work them out again here
+	virtual void contextChanged() {}
+
+	const maxiContext *context = &maxiContext::getDefault();
+};
+
+#endif
@@ -128,7 +128,7 @@ float maxiFFT::spectralCentroid() {
 		x += fabs(magnitudes[i]) * i;
 		y += fabs(magnitudes[i]);
 	}
-	return y != 0 ? x / y * ((float) maxiSettings::sampleRate / fftSize) : 0;
+	return y != 0 ? x / y * (float) (context->sampleRate / fftSize) : 0;
 }
 
 
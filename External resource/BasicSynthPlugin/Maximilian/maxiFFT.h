@@ -36,11 +36,12 @@
 //#define _NO_VDSP  //set this if you don't want to use apple's vDSP fft functions
 
 
+#include "maximilian.h"
 #include "fft.h"
 #include "stddef.h"
 #include <vector>
 
-class maxiFFT {
+class maxiFFT : public maxiContextUser {
 
 public:
 
@@ -149,7 +149,7 @@ public:
 	double inc;
 	double frequency;
 	double* window;
-    double* buffer;
+    const float* buffer;
 #if defined(__APPLE_CC__) && defined(MAXIGRAINFAST)
 	double* grainSamples;
 #endif
@@ -159,7 +159,7 @@ public:
 	 */
 	maxiGrain(maxiSample *sample, const double position, const double duration, const double speed, maxiGrainWindowCache<F> *windowCache) :sample(sample), pos(position), dur(duration), speed(speed) 
 	{
-        buffer = &sample->amplitudes[0];
+        buffer = sample->amplitudes.data();
 //        buffer = sample->temp;
 		sampleStartPos = sample->getLength() * pos;
 		sampleDur = dur * (double)sample->mySampleRate;
@@ -293,6 +293,7 @@ public:
 	maxiGrainWindowCache<F> windowCache;
 	double randomOffset;
     double looper;
+	maxiRandom random; //grain timing jitter, seed it to get the same grains every run
 	
 	maxiTimeStretch(){
 		position=0;
@@ -349,7 +350,7 @@ public:
 			speed = (speed > 0 ? 1 : -1);
 			maxiGrain<F> *g = new maxiGrain<F>(sample, max(min(1.0,(position / sample->getLength()) + posMod),0.0), grainLength, speed, &windowCache);
 			grainPlayer->addGrain(g);
-			randomOffset = rand() % 10;
+			randomOffset = random.below(10);
 		}
 		return grainPlayer->play();
 	}
@@ -444,6 +445,7 @@ public:
 	double randomOffset;
     unsigned  long loopStart, loopEnd, loopLength;
     double looper;
+	maxiRandom random; //grain timing jitter, seed it to get the same grains every run
 	
 	maxiStretch(){
         randomOffset=0;
@@ -520,7 +522,7 @@ public:
                 looper -= (cycleLength + randomOffset);
                 maxiGrain<F> *g = new maxiGrain<F>(sample, max(min(1.0,(position / sample->getLength()) + posMod),0.0), grainLength, pitchstretch, &windowCache);
                 grainPlayer->addGrain(g);
-                randomOffset = rand() % 10;
+                randomOffset = random.below(10);
             }
             return grainPlayer->play();
         }else{
@@ -0,0 +1,160 @@
+//
+//  maxiSamplePool.cpp
+//  Maximilian
+//
+//  Created by Chris on 17/10/2026.
+//
+
+#include "maxiSamplePool.h"
+#include "maxiWavFile.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <sys/stat.h>
+
+using namespace std;
+
+vector<float> &maxiSampleBuffer::edit() {
+	if (!storage) {
+		share(make_shared<vector<float> >(), false);
+	} else if (isShared()) {
+		share(make_shared<vector<float> >(*storage), false);
+	}
+	return *storage;
+}
+
+
+namespace {
+	struct pathEntry {
+		weak_ptr<vector<float> > samples;
+		maxiSampleInfo info;
+	};
+
+	struct poolState {
+		mutex lock;
+		unordered_map<string, pathEntry> byPath;
+		unordered_multimap<uint64_t, weak_ptr<vector<float> > > byContent;
+
+		//forget the samples nothing holds any more
+		void prune() {
+			for (auto i = byPath.begin(); i != byPath.end();) {
+				i = i->second.samples.expired() ? byPath.erase(i) : next(i);
+			}
+			for (auto i = byContent.begin(); i != byContent.end();) {
+				i = i->second.expired() ? byContent.erase(i) : next(i);
+			}
+		}
+	};
+
+	poolState &state() {
+		static poolState pool;
+		return pool;
+	}
+
+	//size and modification time, so a file changed on disk is loaded again
+	bool fileStamp(const string &path, string &stamp) {
+#ifdef _WIN32
+		struct _stat64 info;
+		if (_stat64(path.c_str(), &info) != 0) return false;
+#else
+		struct stat info;
+		if (stat(path.c_str(), &info) != 0) return false;
+#endif
+		stamp = to_string((long long) info.st_size) + ":" + to_string((long long) info.st_mtime);
+		return true;
+	}
+
+	//four independent multiply-xorshift lanes over the raw bits, so it runs at memory speed
+	uint64_t hashSamples(const vector<float> &samples) {
+		const size_t words = samples.size() / 2;
+		const unsigned char *bytes = (const unsigned char *) samples.data();
+		uint64_t lane[4] = {0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL, samples.size()};
+		size_t i = 0;
+		for (; i + 4 <= words; i += 4) {
+			for (int j = 0; j < 4; j++) {
+				uint64_t word;
+				memcpy(&word, bytes + (i + j) * 8, 8);
+				lane[j] = (lane[j] ^ word) * 0xFF51AFD7ED558CCDULL;
+				lane[j] ^= lane[j] >> 32;
+			}
+		}
+		uint64_t hash = lane[0] ^ (lane[1] * 3) ^ (lane[2] * 5) ^ (lane[3] * 7);
+		for (size_t k = i * 2; k < samples.size(); k++) {
+			uint32_t bits;
+			memcpy(&bits, &samples[k], 4);
+			hash = (hash ^ bits) * 0xFF51AFD7ED558CCDULL;
+		}
+		return hash ^ (hash >> 29);
+	}
+}
+
+bool maxiSamplePool::load(const string &path, int channel, maxiSampleBuffer &buffer, maxiSampleInfo &info) {
+	string stamp;
+	if (!fileStamp(path, stamp)) return false;
+	const string key = path + "|" + to_string(channel) + "|" + stamp;
+	poolState &pool = state();
+
+	{
+		lock_guard<mutex> lock(pool.lock);
+		pool.prune();
+		auto found = pool.byPath.find(key);
+		if (found != pool.byPath.end()) {
+			shared_ptr<vector<float> > samples = found->second.samples.lock();
+			if (samples) {
+				buffer.share(samples, true);
+				info = found->second.info;
+				return true;
+			}
+		}
+	}
+
+	//decode outside the lock so other files can load meanwhile. Two threads loading the same new
+	//file at once both decode it, and the second one finds the first one's samples below.
+	maxiWavFile file;
+	if (!file.open(path)) return false;
+	maxiSampleInfo newInfo;
+	newInfo.channels = file.getNumChannels();
+	newInfo.sampleRate = file.getSampleRate();
+	newInfo.bitsPerSample = file.getBitsPerSample();
+	newInfo.isFloat = file.getSampleFormat() == maxiWavFile::FLOAT32;
+	shared_ptr<vector<float> > samples = make_shared<vector<float> >((size_t) file.getNumFrames());
+	file.readChannel(min(max(channel, 0), newInfo.channels - 1), samples->data(), 0, samples->size());
+	const uint64_t hash = hashSamples(*samples);
+
+	lock_guard<mutex> lock(pool.lock);
+	bool found = false;
+	auto range = pool.byContent.equal_range(hash);
+	for (auto i = range.first; i != range.second && !found; i++) {
+		shared_ptr<vector<float> > existing = i->second.lock();
+		if (existing && existing->size() == samples->size() &&
+			memcmp(existing->data(), samples->data(), samples->size() * sizeof(float)) == 0) {
+			samples = existing;
+			found = true;
+		}
+	}
+	if (!found) pool.byContent.emplace(hash, samples);
+	pool.byPath[key] = pathEntry {samples, newInfo};
+
+	buffer.share(samples, true);
+	info = newInfo;
+	return true;
+}
+
+size_t maxiSamplePool::getNumBuffers() {
+	poolState &pool = state();
+	lock_guard<mutex> lock(pool.lock);
+	pool.prune();
+	return pool.byContent.size();
+}
+
+size_t maxiSamplePool::getNumBytes() {
+	poolState &pool = state();
+	lock_guard<mutex> lock(pool.lock);
+	size_t bytes = 0;
+	for (auto &entry : pool.byContent) {
+		shared_ptr<vector<float> > samples = entry.second.lock();
+		if (samples) bytes += samples->size() * sizeof(float);
+	}
+	return bytes;
+}
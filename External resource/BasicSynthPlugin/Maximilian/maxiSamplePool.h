@@ -0,0 +1,98 @@
+//
+//  maxiSamplePool.h
+//  Maximilian
+//
+//  Created by Chris on 17/10/2026.
+//
+//  Sample data shared between every player that loads the same file.
+
+#ifndef maxiSamplePool_h
+#define maxiSamplePool_h
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/*
+ One channel of sample data, shared by handle. Copying a buffer is a reference count, not a copy
+ of the samples, so any number of voices can hold the same sound. Reading never copies; edit()
+ makes the buffer its own first if anything else holds it, so a change only ever shows in the
+ buffer it was made through.
+ */
+class maxiSampleBuffer {
+public:
+	maxiSampleBuffer() : samples(nullptr), length(0), pooled(false) {}
+	maxiSampleBuffer(std::vector<float> &&data) { *this = std::move(data); }
+
+	maxiSampleBuffer &operator=(std::vector<float> &&data) {
+		share(std::make_shared<std::vector<float> >(std::move(data)), false);
+		return *this;
+	}
+
+	const float &operator[](size_t index) const { return samples[index]; }
+	const float *data() const { return samples; }
+	size_t size() const { return length; }
+	bool empty() const { return length == 0; }
+	void clear() { share(nullptr, false); }
+
+	//true if another buffer holds the same samples
+	bool isShared() const { return pooled || storage.use_count() > 1; }
+
+	//the samples to write to, copied first if they're shared. Write to them but don't resize them,
+	//assign a new vector for that.
+	std::vector<float> &edit();
+
+	//the samples to write to if nothing else holds them, otherwise nullptr. Never copies, so it's
+	//safe on the audio thread after an edit() beforehand.
+	float *getWritePointer() { return storage && !isShared() ? storage->data() : nullptr; }
+
+private:
+	friend class maxiSamplePool;
+
+	void share(const std::shared_ptr<std::vector<float> > &newStorage, bool fromPool) {
+		storage = newStorage;
+		samples = storage ? storage->data() : nullptr;
+		length = storage ? storage->size() : 0;
+		pooled = fromPool;
+	}
+
+	std::shared_ptr<std::vector<float> > storage;
+	const float *samples;   //storage->data(), kept here so a read is one load
+	size_t length;
+	bool pooled;            //the pool can hand these samples out again, so never write to them
+};
+
+
+//the header fields of the file a pooled buffer came from
+struct maxiSampleInfo {
+	int channels = 1, sampleRate = 44100, bitsPerSample = 16;
+	bool isFloat = false;
+};
+
+
+/*
+ Every wave file loaded through maxiSample, held once for the whole process however many players,
+ voices or plugin instances load it. Files are looked up by path, channel, size and modification
+ time, so loading one again costs a map lookup. A file not seen before is decoded and then looked
+ up by a hash of its samples, so the same sound under another name is shared too. The pool only
+ holds weak references: the samples are freed when the last buffer using them goes.
+ Safe to call from several threads at once, but it reads files, so not from the audio thread.
+ usage:
+
+ maxiSampleBuffer kick;
+ maxiSampleInfo info;
+ maxiSamplePool::load("drums/kick.wav", 0, kick, info);
+
+ */
+class maxiSamplePool {
+public:
+	//false if the file can't be read, and then buffer and info are left alone
+	static bool load(const std::string &path, int channel, maxiSampleBuffer &buffer, maxiSampleInfo &info);
+
+	//how many distinct buffers are alive, and the memory they take
+	static size_t getNumBuffers();
+	static size_t getNumBytes();
+};
+
+#endif
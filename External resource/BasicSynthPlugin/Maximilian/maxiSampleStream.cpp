@@ -0,0 +1,273 @@
+//
+//  maxiSampleStream.cpp
+//  Maximilian
+//
+//  Created by Chris on 17/10/2026.
+//
+
+#include "maxiSampleStream.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+//frames the loader reads at a time, and asks the operating system to page in ahead of that
+static const uint64_t chunkFrames = 4096;
+static const uint64_t readAheadFrames = chunkFrames * 4;
+
+/*
+ The one thread that fills every open stream's ring. It goes round the streams until none of them
+ has room for another chunk, then sleeps a couple of milliseconds. Streams hold it with a
+ shared_ptr, so it starts with the first stream opened and stops when the last one is closed.
+ */
+class maxiSampleStreamLoader {
+public:
+	maxiSampleStreamLoader() : quit(false), worker(&maxiSampleStreamLoader::run, this) {}
+
+	~maxiSampleStreamLoader() {
+		{
+			lock_guard<mutex> lock(streamsMutex);
+			quit = true;
+		}
+		wake.notify_one();
+		worker.join();
+	}
+
+	static shared_ptr<maxiSampleStreamLoader> get() {
+		static mutex instanceMutex;
+		static weak_ptr<maxiSampleStreamLoader> instance;
+		lock_guard<mutex> lock(instanceMutex);
+		shared_ptr<maxiSampleStreamLoader> loader = instance.lock();
+		if (!loader) {
+			loader = make_shared<maxiSampleStreamLoader>();
+			instance = loader;
+		}
+		return loader;
+	}
+
+	void add(maxiSampleStream *stream) {
+		{
+			lock_guard<mutex> lock(streamsMutex);
+			streams.push_back(stream);
+		}
+		wake.notify_one();
+	}
+
+	//once this returns the loader won't touch the stream again
+	void remove(maxiSampleStream *stream) {
+		lock_guard<mutex> lock(streamsMutex);
+		streams.erase(std::remove(streams.begin(), streams.end(), stream), streams.end());
+	}
+
+private:
+	void run() {
+		unique_lock<mutex> lock(streamsMutex);
+		while (!quit) {
+			bool busy = false;
+			for (maxiSampleStream *stream : streams) busy |= stream->service();
+			if (busy) {
+				//let add and remove in between passes
+				lock.unlock();
+				this_thread::yield();
+				lock.lock();
+			} else {
+				wake.wait_for(lock, chrono::milliseconds(2));
+			}
+		}
+	}
+
+	mutex streamsMutex;
+	condition_variable wake;
+	vector<maxiSampleStream *> streams;
+	bool quit;
+	thread worker;
+};
+
+
+maxiSampleStream::maxiSampleStream() : channel(0), numFrames(0), ringMask(0), position(0), startIndex(0),
+	loopStart(0), loopEnd(0), generation(0), looping(true), requestGeneration(0), requestStart(0),
+	requestLoopStart(0), requestLoopEnd(0), requestLooping(true), consumed(0), underruns(0),
+	loaderGeneration(requestBusy), writeIndex(0), loaderLoopStart(0), loaderLoopEnd(0),
+	loaderLooping(true), written(0) {
+}
+
+maxiSampleStream::~maxiSampleStream() {
+	close();
+}
+
+bool maxiSampleStream::load(const string &path, int channelIn, int headFrames, int ringFrames) {
+	close();
+	if (!file.open(path) || file.getNumFrames() == 0) {
+		file.close();
+		return false;
+	}
+
+	channel = min(max(channelIn, 0), file.getNumChannels() - 1);
+	numFrames = file.getNumFrames();
+	head.resize((size_t) min((uint64_t) max(headFrames, 0), numFrames));
+	file.readChannel(channel, head.data(), 0, head.size());
+
+	uint64_t ringSize = chunkFrames * 2;
+	while (ringSize < (uint64_t) ringFrames) ringSize <<= 1;
+	ring.assign((size_t) ringSize, 0.f);
+	ringMask = ringSize - 1;
+
+	loopStart = 0;
+	loopEnd = numFrames;
+	underruns.store(0, memory_order_relaxed);
+	restart(0, true);
+
+	loader = maxiSampleStreamLoader::get();
+	loader->add(this);
+	return true;
+}
+
+void maxiSampleStream::close() {
+	if (loader) {
+		loader->remove(this);
+		loader.reset();
+	}
+	file.close();
+	numFrames = 0;
+	head.clear();
+	ring.clear();
+}
+
+void maxiSampleStream::setLoopPoints(double start, double end) {
+	if (numFrames == 0) return;
+	start = min(max(start, 0.0), 1.0);
+	end = min(max(end, start), 1.0);
+	const uint64_t current = fileFrame((uint64_t) position, looping, loopStart, loopEnd);
+	const double fraction = position - floor(position);
+
+	loopStart = min((uint64_t) (start * numFrames), numFrames - 1);
+	loopEnd = max((uint64_t) (end * numFrames), loopStart + 1);
+	loopEnd = min(loopEnd, numFrames);
+
+	//the frames already in the ring were laid out for the old loop
+	if (looping) {
+		restart(current, true);
+		position += fraction;
+	}
+}
+
+void maxiSampleStream::setPosition(double fraction) {
+	if (numFrames == 0) return;
+	fraction = min(max(fraction, 0.0), 1.0);
+	restart(min((uint64_t) (fraction * numFrames), numFrames - 1), looping);
+}
+
+void maxiSampleStream::restart(uint64_t startFrame, bool loop) {
+	looping = loop;
+	if (looping && startFrame >= loopEnd) startFrame = loopStart;
+	position = (double) startFrame;
+	startIndex = startFrame;
+	generation = (generation + 1) & 0xFFFF;
+
+	//a seqlock, the loader ignores the request while it's busy or if it changed under it
+	requestGeneration.store(requestBusy, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	requestStart.store(startFrame, memory_order_relaxed);
+	requestLoopStart.store(loopStart, memory_order_relaxed);
+	requestLoopEnd.store(loopEnd, memory_order_relaxed);
+	requestLooping.store(looping, memory_order_relaxed);
+	requestGeneration.store(generation, memory_order_release);
+	consumed.store(pack(generation, startFrame), memory_order_release);
+}
+
+inline float maxiSampleStream::frame(uint64_t index, uint64_t writtenTo, bool &ready) const {
+	const uint64_t f = fileFrame(index, looping, loopStart, loopEnd);
+	if (f >= numFrames) return 0.f;     //past the end of a one shot
+	if (f < head.size()) return head[f];
+	if (index >= writtenTo) {
+		ready = false;
+		return 0.f;
+	}
+	return ring[index & ringMask];
+}
+
+double maxiSampleStream::next(double speed, bool loop) {
+	if (numFrames == 0) return 0;
+	if (loop != looping) {
+		const double fraction = position - floor(position);
+		restart(fileFrame((uint64_t) position, looping, loopStart, loopEnd), loop);
+		position += fraction;
+	}
+
+	const uint64_t index = (uint64_t) position;
+	if (!looping && index >= numFrames) return 0;
+
+	const uint64_t state = written.load(memory_order_acquire);
+	const uint64_t writtenTo = generationOf(state) == generation ? indexOf(state) : 0;
+
+	bool ready = true;
+	const float a = frame(index, writtenTo, ready);
+	const float b = frame(index + 1, writtenTo, ready);
+	double output = 0;
+	if (ready) {
+		output = a + (b - a) * (position - index);    //linear interpolation
+	} else {
+		underruns.fetch_add(1, memory_order_relaxed);
+	}
+
+	position += max(speed, 0.0) * file.getSampleRate() * context->sampleDuration;
+	consumed.store(pack(generation, (uint64_t) position), memory_order_release);
+	return output;
+}
+
+void maxiSampleStream::play(float *output, int numSamples, double speed) {
+	for (int i = 0; i < numSamples; i++) output[i] = (float) next(speed, true);
+}
+
+bool maxiSampleStream::service() {
+	const uint32_t request = requestGeneration.load(memory_order_acquire);
+	if (request == requestBusy) return false;
+	if (request != loaderGeneration) {
+		const uint64_t start = requestStart.load(memory_order_relaxed);
+		const uint64_t newLoopStart = requestLoopStart.load(memory_order_relaxed);
+		const uint64_t newLoopEnd = requestLoopEnd.load(memory_order_relaxed);
+		const bool newLooping = requestLooping.load(memory_order_relaxed);
+		atomic_thread_fence(memory_order_acquire);
+		if (requestGeneration.load(memory_order_relaxed) != request) return false;
+
+		loaderGeneration = request;
+		writeIndex = start;
+		loaderLoopStart = newLoopStart;
+		loaderLoopEnd = newLoopEnd;
+		loaderLooping = newLooping;
+		written.store(pack(loaderGeneration, writeIndex), memory_order_release);
+	}
+
+	const uint64_t state = consumed.load(memory_order_acquire);
+	if (generationOf(state) != loaderGeneration) return false;
+	//after an underrun skip what the audio thread has already gone past
+	const uint64_t readIndex = indexOf(state);
+	writeIndex = max(writeIndex, readIndex);
+	if (readIndex + ring.size() - writeIndex < chunkFrames) return false;
+
+	uint64_t done = 0;
+	while (done < chunkFrames) {
+		const uint64_t index = writeIndex + done;
+		const uint64_t f = fileFrame(index, loaderLooping, loaderLoopStart, loaderLoopEnd);
+		if (f >= numFrames) break;      //the end of a one shot
+		const uint64_t slot = index & ringMask;
+		uint64_t run = min(chunkFrames - done, ring.size() - slot);
+		run = min(run, (loaderLooping ? loaderLoopEnd : numFrames) - f);
+		if (f < head.size()) {
+			run = min(run, (uint64_t) head.size() - f);
+			copy(head.begin() + f, head.begin() + f + run, ring.begin() + slot);
+		} else {
+			file.readChannel(channel, &ring[slot], f, run);
+		}
+		done += run;
+	}
+	if (done == 0) return false;
+
+	writeIndex += done;
+	written.store(pack(loaderGeneration, writeIndex), memory_order_release);
+	file.prefetch(fileFrame(writeIndex, loaderLooping, loaderLoopStart, loaderLoopEnd), readAheadFrames);
+	return true;
+}
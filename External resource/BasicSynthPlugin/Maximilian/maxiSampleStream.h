@@ -0,0 +1,116 @@
+//
+//  maxiSampleStream.h
+//  Maximilian
+//
+//  Created by Chris on 17/10/2026.
+//
+//  Sample playback straight from disk, for files too big to hold in memory.
+
+#ifndef maxiSampleStream_h
+#define maxiSampleStream_h
+
+#include "maximilian.h"
+#include "maxiWavFile.h"
+#include <atomic>
+#include <memory>
+
+class maxiSampleStreamLoader;
+
+/*
+ Plays one channel of a wave file without loading it. The first headFrames are kept in memory so
+ the sample can start, or be retriggered, at once, and the rest is read into a ring of ringFrames
+ by a background thread shared by every stream, a little ahead of the playback position. The
+ audio thread never blocks or allocates: it reads the head and the ring, and if the disk falls
+ behind it plays silence until the ring catches up, counting each miss in getUnderruns().
+
+ play() and play(speed) loop between the loop points, playOnce() and playOnce(speed) stop at the
+ end of the file. Speed is a ratio of the file's own pitch, converted to the context's sample
+ rate, and only forwards. Switching between looping and one shot playback, moving the loop points
+ or setting the position restart the stream there, which plays from the head if it's within it
+ and otherwise gives silence for as long as the first read from disk takes.
+ usage:
+
+ maxiSampleStream bed;
+ bed.load("beds/forest.wav");
+
+ out = bed.play();
+
+ */
+class maxiSampleStream : public maxiContextUser {
+public:
+	maxiSampleStream();
+	~maxiSampleStream();
+
+	//Opens the file, reads the head and starts streaming from the start. ringFrames is rounded up
+	//to a power of two. Allocates and touches the disk, so not from the audio thread.
+	bool load(const std::string &path, int channel = 0, int headFrames = 65536, int ringFrames = 131072);
+	void close();
+	bool isOpen() const { return file.isOpen(); }
+
+	uint64_t getLength() const { return numFrames; }
+	int getSampleRate() const { return file.getSampleRate(); }
+	unsigned int getUnderruns() const { return underruns.load(std::memory_order_relaxed); }
+
+	//start and end as fractions of the length, like maxiSample::playLoop
+	void setLoopPoints(double start, double end);
+	void setPosition(double fraction);
+	void trigger() { setPosition(0); }
+
+	double play() { return play(1.0); }
+	double play(double speed) { return next(speed, true); }
+	double playOnce() { return playOnce(1.0); }
+	double playOnce(double speed) { return next(speed, false); }
+	void play(float *output, int numSamples, double speed = 1.0);
+
+private:
+	friend class maxiSampleStreamLoader;
+
+	double next(double speed, bool loop);
+	float frame(uint64_t index, uint64_t written, bool &ready) const;
+	void restart(uint64_t startFrame, bool loop);
+	bool service();     //on the loader's thread, true if it read anything
+
+	//stream index to file frame, the stream carries on counting past the loop end
+	static uint64_t fileFrame(uint64_t index, bool loop, uint64_t loopStart, uint64_t loopEnd) {
+		return loop && index >= loopEnd ? loopStart + (index - loopStart) % (loopEnd - loopStart) : index;
+	}
+
+	//the ring's state goes between the threads as a generation, which a restart bumps, in the top
+	//16 bits and a stream index in the rest, so one load sees both together
+	static uint64_t pack(uint32_t generation, uint64_t index) { return ((uint64_t) generation << 48) | index; }
+	static uint32_t generationOf(uint64_t packed) { return (uint32_t) (packed >> 48); }
+	static uint64_t indexOf(uint64_t packed) { return packed & 0xFFFFFFFFFFFFULL; }
+	static const uint32_t requestBusy = 0x10000;
+
+	maxiWavFile file;
+	int channel;
+	uint64_t numFrames;
+	std::vector<float> head, ring;
+	uint64_t ringMask;
+	std::shared_ptr<maxiSampleStreamLoader> loader;
+
+	//audio thread
+	double position;
+	uint64_t startIndex, loopStart, loopEnd;
+	uint32_t generation;
+	bool looping;
+
+	//audio thread to loader, the restart the loader should follow. The generation is written last,
+	//and set to requestBusy while the rest change.
+	std::atomic<uint32_t> requestGeneration;
+	std::atomic<uint64_t> requestStart, requestLoopStart, requestLoopEnd;
+	std::atomic<bool> requestLooping;
+	std::atomic<uint64_t> consumed;     //the lowest stream index the audio thread still needs
+	std::atomic<unsigned int> underruns;
+
+	//loader
+	uint32_t loaderGeneration;
+	uint64_t writeIndex, loaderLoopStart, loaderLoopEnd;
+	bool loaderLooping;
+	std::atomic<uint64_t> written;      //the ring holds everything from the restart up to here
+
+	maxiSampleStream(const maxiSampleStream &) = delete;
+	maxiSampleStream &operator=(const maxiSampleStream &) = delete;
+};
+
+#endif
@@ -0,0 +1,116 @@
+//
+//  maxiTables.h
+//  Maximilian
+//
+//  Created by Chris on 17/10/2026.
+//
+//  Lookup tables built by the compiler, so they are exact to the precision they are stored at
+//  and can be made any size without pasting in thousands of numbers.
+
+#ifndef maxiTables_h
+#define maxiTables_h
+
+#include <cstddef>
+
+/*
+ Maths the compiler can run while it builds the tables. Accurate to a few units in the last
+ place of a double, but slow, so only use these in constant expressions.
+ */
+namespace maxiConstexprMath {
+
+	constexpr double floor(double x) {
+		const double whole = (double) (long long) x;
+		return whole > x ? whole - 1.0 : whole;
+	}
+
+	//sin(2*PI*x) with x in cycles
+	constexpr double sinCycles(double x) {
+		x -= floor(x);                     //0 .. 1
+		double sign = 1.0;
+		if (x >= 0.5) {                    //the second half cycle is the first one upside down
+			x -= 0.5;
+			sign = -1.0;
+		}
+		if (x > 0.25) x = 0.5 - x;         //and each quarter mirrors the one before it
+
+		//Taylor series around 0 for the first eighth of a cycle, cosine around a quarter for the next
+		const bool nearPeak = x > 0.125;
+		const double r = (nearPeak ? 0.25 - x : x) * 6.283185307179586476925286766559;
+		const double r2 = r * r;
+		double term = nearPeak ? 1.0 : r;
+		double sum = term;
+		for (int n = nearPeak ? 1 : 2; n < 22; n += 2) {
+			term *= -r2 / (n * (n + 1));
+			sum += term;
+		}
+		return sign * sum;
+	}
+
+	//2 to the power x
+	constexpr double exp2(double x) {
+		const double whole = floor(x);
+		const double r = (x - whole) * 0.69314718055994530941723212145818;  //0 .. ln 2
+		double term = 1.0;
+		double sum = 1.0;
+		for (int n = 1; n < 24; n++) {
+			term *= r / n;
+			sum += term;
+		}
+		for (int i = 0; i < whole; i++) sum *= 2.0;
+		for (int i = 0; i > whole; i--) sum *= 0.5;
+		return sum;
+	}
+}
+
+
+/*
+ A table of size values of type T, filled at compile time from Shape::value(index) and aligned to
+ a cache line so an interpolated read touches as few lines as possible.
+ usage:
+
+ static constexpr maxiTable<float, 4098, maxiSineShape<4096> > bigSine {};
+
+ */
+template <typename T, int size, class Shape>
+struct alignas(64) maxiTable {
+	T values[size];
+
+	constexpr maxiTable() : values() {
+		for (int i = 0; i < size; i++) values[i] = (T) Shape::value(i);
+	}
+
+	constexpr const T &operator[](std::ptrdiff_t index) const { return values[index]; }
+	constexpr const T *data() const { return values; }
+
+	static constexpr int length = size;
+};
+
+
+//sin(2*PI*index/points). Tables of points + 2 leave room to interpolate past the end of a cycle.
+template <int points>
+struct maxiSineShape {
+	static constexpr double value(int index) { return maxiConstexprMath::sinCycles((double) index / points); }
+};
+
+//The step maxiOsc::sawn rounds its reset off with, from -0.5 to 0.5 over points values. It's the
+//first and third harmonics of a square wave, 0.75 sin(x) + 0.25 sin(3x) for x from -PI/2 to PI/2,
+//which peaks at +-0.707 on the way.
+template <int points>
+struct maxiTransitionShape {
+	static constexpr double value(int index) {
+		const double s = maxiConstexprMath::sinCycles(((double) index * 2 / (points - 1) - 1) * 0.25);
+		return 1.5 * s - s * s * s;
+	}
+};
+
+//equal tempered frequency in Hz of each midi note, A4 (69) at 440
+struct maxiMtofShape {
+	static constexpr double value(int index) { return 440.0 * maxiConstexprMath::exp2((index - 69) / 12.0); }
+};
+
+//equal tempered pitch ratio of each semitone from -127 to +128, 1 at index 127
+struct maxiPitchRatioShape {
+	static constexpr double value(int index) { return maxiConstexprMath::exp2((index - 127) / 12.0); }
+};
+
+#endif
@@ -0,0 +1,211 @@
+//
+//  maxiWavFile.cpp
+//  Maximilian
+//
+//  Created by Chris on 17/10/2026.
+//
+
+#include "maxiWavFile.h"
+#include <cstring>
+#include <algorithm>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+//wave files are little endian whatever the machine is
+static inline uint32_t readLE16(const unsigned char *p) { return p[0] | (p[1] << 8); }
+static inline uint32_t readLE32(const unsigned char *p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24); }
+static inline uint64_t readLE64(const unsigned char *p) { return readLE32(p) | ((uint64_t) readLE32(p + 4) << 32); }
+
+maxiWavFile::maxiWavFile() : mapping(nullptr), mappingSize(0), data(nullptr), numFrames(0), numChannels(0),
+	sampleRate(0), bitsPerSample(0), bytesPerFrame(0), format(PCM16)
+#ifdef _WIN32
+	, fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr)
+#endif
+{
+}
+
+maxiWavFile::~maxiWavFile() {
+	close();
+}
+
+bool maxiWavFile::open(const string &path) {
+	close();
+
+#ifdef _WIN32
+	fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE) return false;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(fileHandle, &size) || size.QuadPart == 0) {
+		close();
+		return false;
+	}
+	mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mappingHandle == nullptr) {
+		close();
+		return false;
+	}
+	mapping = (const unsigned char *) MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	mappingSize = (uint64_t) size.QuadPart;
+#else
+	const int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size == 0) {
+		::close(fd);
+		return false;
+	}
+	void *address = mmap(nullptr, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);    //the mapping keeps the file open
+	if (address == MAP_FAILED) return false;
+	mapping = (const unsigned char *) address;
+	mappingSize = (uint64_t) info.st_size;
+#endif
+
+	if (mapping == nullptr || !parse()) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+void maxiWavFile::close() {
+#ifdef _WIN32
+	if (mapping != nullptr) UnmapViewOfFile(mapping);
+	if (mappingHandle != nullptr) CloseHandle(mappingHandle);
+	if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+	mappingHandle = nullptr;
+	fileHandle = INVALID_HANDLE_VALUE;
+#else
+	if (mapping != nullptr) munmap((void *) mapping, (size_t) mappingSize);
+#endif
+	mapping = nullptr;
+	mappingSize = 0;
+	data = nullptr;
+	numFrames = 0;
+	numChannels = 0;
+}
+
+bool maxiWavFile::parse() {
+	if (mappingSize < 12 || memcmp(mapping + 8, "WAVE", 4) != 0) return false;
+	const bool rf64 = memcmp(mapping, "RF64", 4) == 0 || memcmp(mapping, "BW64", 4) == 0;
+	if (!rf64 && memcmp(mapping, "RIFF", 4) != 0) return false;
+
+	//RF64 keeps the real 64 bit sizes in a ds64 chunk and puts 0xFFFFFFFF in the data chunk
+	uint64_t bigDataSize = 0;
+	uint64_t dataSize = 0;
+	int formatTag = 0;
+	bool haveFormat = false;
+
+	uint64_t pos = 12;
+	while (pos + 8 <= mappingSize) {
+		const unsigned char *chunk = mapping + pos;
+		uint64_t size = readLE32(chunk + 4);
+		const unsigned char *body = chunk + 8;
+		const uint64_t available = mappingSize - (pos + 8);
+
+		if (memcmp(chunk, "ds64", 4) == 0 && size >= 16 && available >= 16) {
+			bigDataSize = readLE64(body + 8);
+		} else if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16 && available >= 16) {
+			formatTag = (int) readLE16(body);
+			numChannels = (int) readLE16(body + 2);
+			sampleRate = (int) readLE32(body + 4);
+			bytesPerFrame = (int) readLE16(body + 12);
+			bitsPerSample = (int) readLE16(body + 14);
+			//WAVE_FORMAT_EXTENSIBLE, the real format is the first two bytes of the sub format GUID
+			if (formatTag == 0xFFFE && size >= 40 && available >= 40) formatTag = (int) readLE16(body + 24);
+			haveFormat = true;
+		} else if (memcmp(chunk, "data", 4) == 0) {
+			if (rf64 && size == 0xFFFFFFFF) size = bigDataSize;
+			//a recorder that never finished its header leaves 0 or 0xFFFFFFFF, take the rest of the file
+			if (size == 0 || size == 0xFFFFFFFF) size = available;
+			dataSize = min(size, available);
+			data = body;
+			break;
+		}
+		pos += 8 + size + (size & 1);   //chunks are padded to an even length
+	}
+
+	if (!haveFormat || data == nullptr || numChannels <= 0) return false;
+
+	if (formatTag == 1 && bitsPerSample == 16) format = PCM16;
+	else if (formatTag == 1 && bitsPerSample == 24) format = PCM24;
+	else if (formatTag == 1 && bitsPerSample == 32) format = PCM32;
+	else if (formatTag == 3 && bitsPerSample == 32) format = FLOAT32;
+	else return false;
+
+	if (bytesPerFrame != numChannels * bitsPerSample / 8) return false;
+	numFrames = dataSize / bytesPerFrame;
+	return true;
+}
+
+void maxiWavFile::readChannel(int channel, float *output, uint64_t startFrame, uint64_t count) const {
+	const uint64_t available = startFrame < numFrames ? min(count, numFrames - startFrame) : 0;
+	if (channel < 0 || channel >= numChannels) {
+		fill(output, output + count, 0.f);
+		return;
+	}
+
+	const int bytesPerSample = bitsPerSample / 8;
+	const unsigned char *in = data + startFrame * bytesPerFrame + channel * bytesPerSample;
+	const size_t stride = bytesPerFrame;
+
+	switch (format) {
+		case PCM16:
+			for (uint64_t i = 0; i < available; i++, in += stride) {
+				output[i] = (int16_t) readLE16(in) * (1.f / 32768.f);
+			}
+			break;
+		case PCM24:
+			for (uint64_t i = 0; i < available; i++, in += stride) {
+				//into the top of an int so the sign comes along
+				const int32_t value = (int32_t) (((uint32_t) in[0] << 8) | ((uint32_t) in[1] << 16) | ((uint32_t) in[2] << 24));
+				output[i] = (float) value * (1.f / 2147483648.f);
+			}
+			break;
+		case PCM32:
+			for (uint64_t i = 0; i < available; i++, in += stride) {
+				output[i] = (float) (int32_t) readLE32(in) * (1.f / 2147483648.f);
+			}
+			break;
+		case FLOAT32:
+			for (uint64_t i = 0; i < available; i++, in += stride) {
+				const uint32_t bits = readLE32(in);
+				memcpy(&output[i], &bits, 4);
+			}
+			break;
+	}
+	fill(output + available, output + count, 0.f);
+}
+
+const int16_t *maxiWavFile::getInt16Samples() const {
+	return format == PCM16 ? (const int16_t *) data : nullptr;
+}
+
+void maxiWavFile::prefetch(uint64_t startFrame, uint64_t count) const {
+	if (data == nullptr || startFrame >= numFrames) return;
+	count = min(count, numFrames - startFrame);
+	const unsigned char *first = data + startFrame * bytesPerFrame;
+	const size_t length = (size_t) (count * bytesPerFrame);
+#ifdef _WIN32
+	WIN32_MEMORY_RANGE_ENTRY range;
+	range.VirtualAddress = (void *) first;
+	range.NumberOfBytes = length;
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+	//madvise wants a page aligned start
+	const uintptr_t pageMask = (uintptr_t) sysconf(_SC_PAGESIZE) - 1;
+	const uintptr_t alignedStart = (uintptr_t) first & ~pageMask;
+	madvise((void *) alignedStart, length + ((uintptr_t) first - alignedStart), MADV_WILLNEED);
+#endif
+}
@@ -0,0 +1,77 @@
+//
+//  maxiWavFile.h
+//  Maximilian
+//
+//  Created by Chris on 17/10/2026.
+//
+//  Memory mapped reader for WAV, RF64 and BW64 files.
+
+#ifndef maxiWavFile_h
+#define maxiWavFile_h
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ Maps a wave file into memory rather than reading it, so opening costs a header parse however big
+ the file is and the operating system pages the audio in as it's read. Handles 16, 24 and 32 bit
+ integer PCM and 32 bit float, in any number of channels, in plain RIFF files, files with the
+ WAVE_FORMAT_EXTENSIBLE header and RF64/BW64 files over 4GB.
+ usage:
+
+ maxiWavFile file;
+ if (file.open("beds/forest.wav")) {
+	 std::vector<float> left(file.getNumFrames());
+	 file.readChannel(0, left.data(), 0, left.size());
+ }
+
+ */
+class maxiWavFile {
+public:
+	enum sampleFormats {PCM16, PCM24, PCM32, FLOAT32};
+
+	maxiWavFile();
+	~maxiWavFile();
+
+	//false if the file can't be mapped or isn't a wave file in one of the formats above
+	bool open(const std::string &path);
+	void close();
+	bool isOpen() const { return data != nullptr; }
+
+	int getNumChannels() const { return numChannels; }
+	int getSampleRate() const { return sampleRate; }
+	int getBitsPerSample() const { return bitsPerSample; }
+	sampleFormats getSampleFormat() const { return format; }
+	uint64_t getNumFrames() const { return numFrames; }
+
+	//Converts numFrames of one channel, from startFrame on, to floats from -1 to 1. Frames past the
+	//end of the file are written as silence. Safe to call from several threads at once.
+	void readChannel(int channel, float *output, uint64_t startFrame, uint64_t numFrames) const;
+
+	//16 bit files only, the interleaved samples straight from the map, otherwise nullptr
+	const int16_t *getInt16Samples() const;
+
+	//Tells the operating system which frames will be wanted soon, so they can be paged in ahead of
+	//time. Only a hint; it doesn't wait.
+	void prefetch(uint64_t startFrame, uint64_t numFrames) const;
+
+private:
+	bool parse();
+
+	const unsigned char *mapping;   //the whole file
+	uint64_t mappingSize;
+	const unsigned char *data;      //the first sample of the data chunk
+	uint64_t numFrames;
+	int numChannels, sampleRate, bitsPerSample, bytesPerFrame;
+	sampleFormats format;
+
+#ifdef _WIN32
+	void *fileHandle, *mappingHandle;
+#endif
+
+	maxiWavFile(const maxiWavFile &) = delete;
+	maxiWavFile &operator=(const maxiWavFile &) = delete;
+};
+
+#endif
@@ -0,0 +1,203 @@
+//
+//  maxiWavetable.cpp
+//  Maximilian
+//
+//  Created by Chris on 17/10/2026.
+//
+
+#include "maxiWavetable.h"
+#include "fft.h"
+using namespace std;
+
+maxiWavetable::maxiWavetable(const vector<vector<float> > &frames)
+	: numFrames(std::max((int) frames.size(), 1)), data(numLevels * numFrames * stride, 0.f) {
+	const int half = tableSize / 2;
+	fft transform;
+	transform.setup(tableSize);
+	vector<float> window(tableSize, 1.f), frame(tableSize), magnitude(half), phase(half), level(tableSize);
+
+	for (int f = 0; f < (int) frames.size(); f++) {
+		const vector<float> &source = frames[f];
+		if (source.empty()) continue;
+
+		//resample to tableSize, linear is fine as the top of the spectrum is thrown away below
+		const int sourceSize = (int) source.size();
+		for (int i = 0; i < tableSize; i++) {
+			const double position = (double) i * sourceSize / tableSize;
+			const int index = (int) position;
+			const double remainder = position - index;
+			frame[i] = (float) ((1.0 - remainder) * source[index] + remainder * source[(index + 1) % sourceSize]);
+		}
+
+		transform.powerSpectrum(0, &frame[0], &window[0], &magnitude[0], &phase[0]);
+		magnitude[0] = 0; //DC, the real FFT also packs the Nyquist bin in here
+
+		//each level drops the upper half of the harmonics the previous one kept
+		for (int l = 0; l < numLevels; l++) {
+			for (int k = (half >> l) + 1; k < half; k++) {
+				magnitude[k] = 0;
+			}
+			std::fill(level.begin(), level.end(), 0.f);
+			transform.inversePowerSpectrum(0, &level[0], &window[0], &magnitude[0], &phase[0]);
+
+			//only the positive frequencies went in, which halves the amplitude coming out
+			float *table = &data[(l * numFrames + f) * stride];
+			for (int i = 0; i < tableSize; i++) {
+				table[i] = level[i] * 2.f;
+			}
+			table[tableSize] = table[0];
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------
+
+std::mutex &maxiWavetableCache::getLock() {
+	static std::mutex lock;
+	return lock;
+}
+
+std::map<std::string, std::weak_ptr<const maxiWavetable> > &maxiWavetableCache::getTables() {
+	static std::map<std::string, std::weak_ptr<const maxiWavetable> > tables;
+	return tables;
+}
+
+std::shared_ptr<const maxiWavetable> maxiWavetableCache::find(const std::string &name) {
+	std::lock_guard<std::mutex> sl(getLock());
+	auto &tables = getTables();
+	auto found = tables.find(name);
+	return found == tables.end() ? std::shared_ptr<const maxiWavetable>() : found->second.lock();
+}
+
+std::shared_ptr<const maxiWavetable> maxiWavetableCache::get(const std::string &name, const vector<vector<float> > &frames) {
+	//the lock is held while building, which also keeps the fft's shared bit reversal table safe
+	std::lock_guard<std::mutex> sl(getLock());
+	auto &tables = getTables();
+
+	if (auto existing = tables[name].lock())
+		return existing;
+
+	//forget anything nobody is using any more
+	for (auto it = tables.begin(); it != tables.end();) {
+		if (it->second.expired() && it->first != name) it = tables.erase(it);
+		else ++it;
+	}
+
+	auto wavetable = std::make_shared<const maxiWavetable>(frames);
+	tables[name] = wavetable;
+	return wavetable;
+}
+
+std::shared_ptr<const maxiWavetable> maxiWavetableCache::getBasicShapes() {
+	const std::string name = "maxiBasicShapes";
+	if (auto existing = find(name))
+		return existing;
+
+	const int size = maxiWavetable::tableSize;
+	vector<vector<float> > frames(4, vector<float>(size));
+	for (int i = 0; i < size; i++) {
+		const double p = (double) i / size;
+		frames[0][i] = (float) sin(p * TWOPI);
+		frames[1][i] = (float) (p < 0.25 ? p * 4 : p < 0.75 ? 2 - p * 4 : p * 4 - 4);
+		frames[2][i] = (float) (p < 0.5 ? p * 2 : p * 2 - 2);
+		frames[3][i] = p < 0.5 ? 1.f : -1.f;
+	}
+	return get(name, frames);
+}
+
+//------------------------------------------------------------------------------------------------
+
+//One sample from the frame a and the frame nextFrame floats after it, phase in cycles and morph
+//from 0 (all a) to 1 (all the next frame).
+template <typename T> static inline T readFrames(const float *a, int nextFrame, T phase, T morph) {
+	const T x = phase * maxiWavetable::tableSize;
+	const int index = std::min((int) x, maxiWavetable::tableSize - 1); //phase can round up to 1 in float
+	const T remainder = x - index;
+	const float *b = a + nextFrame;
+	const T sa = a[index] + (a[index + 1] - a[index]) * remainder;
+	const T sb = b[index] + (b[index + 1] - b[index]) * remainder;
+	return sa + (sb - sa) * morph;
+}
+
+maxiWavetableOsc::maxiWavetableOsc() : phase(0.0), framePosition(0.0), targetFrame(0.0) {
+}
+
+void maxiWavetableOsc::setWavetable(std::shared_ptr<const maxiWavetable> newWavetable) {
+	//if this drops the last reference the old tables are freed here, so don't do that on the audio thread
+	wavetable = newWavetable;
+	setFrame(targetFrame);
+	framePosition = targetFrame;
+}
+
+void maxiWavetableOsc::setFrame(double position) {
+	const double lastFrame = wavetable ? wavetable->getNumFrames() - 1 : 0;
+	targetFrame = std::min(std::max(position, 0.0), lastFrame);
+}
+
+void maxiWavetableOsc::phaseReset(double phaseIn) {
+	phase = phaseIn - floor(phaseIn);
+}
+
+double maxiWavetableOsc::play(double frequency) {
+	const double phaseInc = (frequency * context->sampleDuration);
+	double output = 0;
+	framePosition = targetFrame;
+
+	if (wavetable) {
+		const int lastFrame = wavetable->getNumFrames() - 1;
+		const int frame = std::min((int) framePosition, std::max(lastFrame - 1, 0));
+		const float *a = wavetable->getTable(maxiWavetable::levelFor(fabs(phaseInc)), frame);
+		output = readFrames(a, lastFrame > 0 ? maxiWavetable::stride : 0, phase, framePosition - frame);
+	}
+
+	phase += phaseInc;
+	if ( phase >= 1.0 ) phase -= 1.0;
+	if ( phase < 0.0 ) phase += 1.0;
+	return(output);
+}
+
+void maxiWavetableOsc::play(float *output, int numSamples, double frequency) {
+	const double phaseInc = (frequency * context->sampleDuration);
+	for (int i = 0; i < numSamples; i++) {
+		output[i] = (float) phase;
+		phase += phaseInc;
+		if ( phase >= 1.0 ) phase -= 1.0;
+		if ( phase < 0.0 ) phase += 1.0;
+	}
+	render(output, numSamples, maxiWavetable::levelFor(fabs(phaseInc)));
+}
+
+void maxiWavetableOsc::play(float *output, const float *frequency, int numSamples) {
+	const double incPerHz = context->sampleDuration;
+	float highest = 0.f;
+	for (int i = 0; i < numSamples; i++) {
+		output[i] = (float) phase;
+		phase += frequency[i] * incPerHz;
+		if ( phase >= 1.0 ) phase -= 1.0;
+		if ( phase < 0.0 ) phase += 1.0;
+		highest = std::max(highest, fabsf(frequency[i]));
+	}
+	render(output, numSamples, maxiWavetable::levelFor(highest * incPerHz));
+}
+
+void maxiWavetableOsc::render(float *output, int numSamples, int level) {
+	//output holds the phase of each sample, the frame position glides to its target over the block
+	if (!wavetable) {
+		std::fill(output, output + numSamples, 0.f);
+		return;
+	}
+
+	const float *frames = wavetable->getTable(level, 0);
+	const int lastFrame = wavetable->getNumFrames() - 1;
+	const int lastPair = std::max(lastFrame - 1, 0);
+	const int nextFrame = lastFrame > 0 ? maxiWavetable::stride : 0;
+	const float start = (float) framePosition;
+	const float step = numSamples > 0 ? (float) ((targetFrame - framePosition) / numSamples) : 0.f;
+
+	for (int i = 0; i < numSamples; i++) {
+		const float position = start + step * (i + 1);
+		const int frame = std::min((int) position, lastPair);
+		output[i] = readFrames(frames + frame * maxiWavetable::stride, nextFrame, output[i], position - frame);
+	}
+	framePosition = targetFrame;
+}
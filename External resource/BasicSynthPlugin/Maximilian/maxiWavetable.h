@@ -0,0 +1,127 @@
+//
+//  maxiWavetable.h
+//  Maximilian
+//
+//  Created by Chris on 17/10/2026.
+//
+//  Mipmapped wavetable oscillator, with a process-wide cache so every oscillator,
+//  voice and plugin instance using the same wavetable shares one copy of it.
+
+#ifndef maxiWavetable_h
+#define maxiWavetable_h
+
+#include "maximilian.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/*
+ A set of single cycle frames, each stored at every mip level. Level 0 keeps all tableSize/2
+ harmonics and each level after that keeps half as many as the one before, so a level can be
+ played without aliasing up to sampleRate / (tableSize >> level). The frames are band limited
+ with the fft class and their DC is removed, the level is otherwise left as given.
+
+ Tables are normally obtained from maxiWavetableCache rather than constructed directly.
+ */
+class maxiWavetable {
+public:
+	static const int tableSize = 2048;
+	static const int numLevels = 11;    //down to the fundamental alone
+
+	//frames of any length are resampled to tableSize before they are analysed
+	maxiWavetable(const std::vector<std::vector<float> > &frames);
+
+	int getNumFrames() const { return numFrames; }
+
+	//tableSize + 1 samples, the last one repeating the first so interpolation never has to wrap
+	const float *getTable(int level, int frame) const {
+		return &data[(level * numFrames + frame) * stride];
+	}
+
+	//the lowest level that won't alias when the table is read at this many cycles per sample
+	static int levelFor(double phaseIncrement) {
+		double step = phaseIncrement * tableSize;
+		int level = 0;
+		while (step > 1.0 && level < numLevels - 1) {
+			step *= 0.5;
+			level++;
+		}
+		return level;
+	}
+
+	static const int stride = tableSize + 1;
+
+private:
+	int numFrames;
+	std::vector<float> data;
+};
+
+
+/*
+ Wavetables shared by name. The cache only holds weak references, so a wavetable is freed
+ when the last oscillator using it lets go and is rebuilt if it is asked for again after that.
+ Building runs an FFT per frame and allocates, so call get() from setup code rather than from
+ the audio thread. Safe to call from any thread.
+ */
+class maxiWavetableCache {
+public:
+	//the wavetable stored under name, or an empty pointer if nothing is holding it
+	static std::shared_ptr<const maxiWavetable> find(const std::string &name);
+
+	//the wavetable stored under name, built from frames if nothing is holding it yet
+	static std::shared_ptr<const maxiWavetable> get(const std::string &name, const std::vector<std::vector<float> > &frames);
+
+	//four frames morphing from sine to triangle to saw to square
+	static std::shared_ptr<const maxiWavetable> getBasicShapes();
+
+private:
+	static std::mutex &getLock();
+	static std::map<std::string, std::weak_ptr<const maxiWavetable> > &getTables();
+};
+
+
+/*
+ Wavetable oscillator. Reads the mip level that suits the frequency with linear interpolation
+ and morphs linearly between neighbouring frames.
+ usage:
+
+ maxiWavetableOsc osc;
+ osc.setWavetable(maxiWavetableCache::getBasicShapes());
+ osc.setFrame(1.5); //halfway between triangle and saw
+
+ w = osc.play(220);
+
+ or for a block, which glides to the new frame position over the block
+
+ osc.play(buffer, numSamples, 220);
+
+ */
+class maxiWavetableOsc : public maxiContextUser {
+public:
+	maxiWavetableOsc();
+
+	void setWavetable(std::shared_ptr<const maxiWavetable> newWavetable);
+
+	//0 to numFrames - 1, fractions morph between frames
+	void setFrame(double position);
+
+	double play(double frequency);
+
+	//block versions, a fixed frequency or one frequency in Hz per sample. With per-sample frequencies
+	//the mip level is chosen for the highest frequency in the block.
+	void play(float *output, int numSamples, double frequency);
+	void play(float *output, const float *frequency, int numSamples);
+
+	void phaseReset(double phaseIn);
+
+private:
+	void render(float *output, int numSamples, int level);
+
+	std::shared_ptr<const maxiWavetable> wavetable;
+	double phase;
+	double framePosition;
+	double targetFrame;
+};
+
+#endif
@@ -34,6 +34,7 @@
 #include "maximilian.h"
 #include "math.h"
 #include <iterator>
+#include <atomic>
 
 /*  Maximilian can be configured to load ogg vorbis format files using the
  *   loadOgg() method.
@@ -57,152 +58,90 @@ int maxiSettings::bufferSize = 1024;
 
 
 //this is a 514-point sinewave table that has many uses.
-double sineBuffer[514]={0,0.012268,0.024536,0.036804,0.049042,0.06131,0.073547,0.085785,0.097992,0.1102,0.12241,0.13455,0.1467,0.15884,0.17093,0.18301,0.19507,0.20709,0.21909,0.23105,0.24295,0.25485,0.26669,0.2785,0.29025,0.30197,0.31366,0.32529,0.33685,0.34839,0.35986,0.37128,0.38266,0.39395,0.40521,0.41641,0.42752,0.4386,0.44958,0.46051,0.47137,0.48215,0.49286,0.50351,0.51407,0.52457,0.53497,0.54529,0.55554,0.5657,0.57578,0.58575,0.59567,0.60547,0.6152,0.62482,0.63437,0.6438,0.65314,0.66238,0.67151,0.68057,0.68951,0.69833,0.70706,0.7157,0.72421,0.7326,0.74091,0.74908,0.75717,0.76514,0.77298,0.7807,0.7883,0.79581,0.80316,0.81042,0.81754,0.82455,0.83142,0.8382,0.84482,0.85132,0.8577,0.86392,0.87006,0.87604,0.88187,0.8876,0.89319,0.89862,0.90396,0.90912,0.91415,0.91907,0.92383,0.92847,0.93295,0.93729,0.9415,0.94556,0.94949,0.95325,0.95691,0.96039,0.96375,0.96692,0.97,0.9729,0.97565,0.97827,0.98074,0.98306,0.98523,0.98724,0.98914,0.99084,0.99243,0.99387,0.99515,0.99628,0.99725,0.99808,0.99875,0.99927,0.99966,0.99988,0.99997,0.99988,0.99966,0.99927,0.99875,0.99808,0.99725,0.99628,0.99515,0.99387,0.99243,0.99084,0.98914,0.98724,0.98523,0.98306,0.98074,0.97827,0.97565,0.9729,0.97,0.96692,0.96375,0.96039,0.95691,0.95325,0.94949,0.94556,0.9415,0.93729,0.93295,0.92847,0.92383,0.91907,0.91415,0.90912,0.90396,0.89862,0.89319,0.8876,0.88187,0.87604,0.87006,0.86392,0.8577,0.85132,0.84482,0.8382,0.83142,0.82455,0.81754,0.81042,0.80316,0.79581,0.7883,0.7807,0.77298,0.76514,0.75717,0.74908,0.74091,0.7326,0.72421,0.7157,0.70706,0.69833,0.68951,0.68057,0.67151,0.66238,0.65314,0.6438,0.63437,0.62482,0.6152,0.60547,0.59567,0.58575,0.57578,0.5657,0.55554,0.54529,0.53497,0.52457,0.51407,0.50351,0.49286,0.48215,0.47137,0.46051,0.44958,0.4386,0.42752,0.41641,0.40521,0.39395,0.38266,0.37128,0.35986,0.34839,0.33685,0.32529,0.31366,0.30197,0.29025,0.2785,0.26669,0.25485,0.24295,0.23105,0.21909,0.20709,0.19507,0.18301,0.17093,0.15884,0.1467,0.13455,0.12241,0.1102,0.097992,0.085785,0.073547,0.06131,0.049042,0.036804,0.024536,0.012268,0,-0.012268,-0.024536,-0.036804,-0.049042,-0.06131,-0.073547,-0.085785,-0.097992,-0.1102,-0.12241,-0.13455,-0.1467,-0.15884,-0.17093,-0.18301,-0.19507,-0.20709,-0.21909,-0.23105,-0.24295,-0.25485,-0.26669,-0.2785,-0.29025,-0.30197,-0.31366,-0.32529,-0.33685,-0.34839,-0.35986,-0.37128,-0.38266,-0.39395,-0.40521,-0.41641,-0.42752,-0.4386,-0.44958,-0.46051,-0.47137,-0.48215,-0.49286,-0.50351,-0.51407,-0.52457,-0.53497,-0.54529,-0.55554,-0.5657,-0.57578,-0.58575,-0.59567,-0.60547,-0.6152,-0.62482,-0.63437,-0.6438,-0.65314,-0.66238,-0.67151,-0.68057,-0.68951,-0.69833,-0.70706,-0.7157,-0.72421,-0.7326,-0.74091,-0.74908,-0.75717,-0.76514,-0.77298,-0.7807,-0.7883,-0.79581,-0.80316,-0.81042,-0.81754,-0.82455,-0.83142,-0.8382,-0.84482,-0.85132,-0.8577,-0.86392,-0.87006,-0.87604,-0.88187,-0.8876,-0.89319,-0.89862,-0.90396,-0.90912,-0.91415,-0.91907,-0.92383,-0.92847,-0.93295,-0.93729,-0.9415,-0.94556,-0.94949,-0.95325,-0.95691,-0.96039,-0.96375,-0.96692,-0.97,-0.9729,-0.97565,-0.97827,-0.98074,-0.98306,-0.98523,-0.98724,-0.98914,-0.99084,-0.99243,-0.99387,-0.99515,-0.99628,-0.99725,-0.99808,-0.99875,-0.99927,-0.99966,-0.99988,-0.99997,-0.99988,-0.99966,-0.99927,-0.99875,-0.99808,-0.99725,-0.99628,-0.99515,-0.99387,-0.99243,-0.99084,-0.98914,-0.98724,-0.98523,-0.98306,-0.98074,-0.97827,-0.97565,-0.9729,-0.97,-0.96692,-0.96375,-0.96039,-0.95691,-0.95325,-0.94949,-0.94556,-0.9415,-0.93729,-0.93295,-0.92847,-0.92383,-0.91907,-0.91415,-0.90912,-0.90396,-0.89862,-0.89319,-0.8876,-0.88187,-0.87604,-0.87006,-0.86392,-0.8577,-0.85132,-0.84482,-0.8382,-0.83142,-0.82455,-0.81754,-0.81042,-0.80316,-0.79581,-0.7883,-0.7807,-0.77298,-0.76514,-0.75717,-0.74908,-0.74091,-0.7326,-0.72421,-0.7157,-0.70706,-0.69833,-0.68951,-0.68057,-0.67151,-0.66238,-0.65314,-0.6438,-0.63437,-0.62482,-0.6152,-0.60547,-0.59567,-0.58575,-0.57578,-0.5657,-0.55554,-0.54529,-0.53497,-0.52457,-0.51407,-0.50351,-0.49286,-0.48215,-0.47137,-0.46051,-0.44958,-0.4386,-0.42752,-0.41641,-0.40521,-0.39395,-0.38266,-0.37128,-0.35986,-0.34839,-0.33685,-0.32529,-0.31366,-0.30197,-0.29025,-0.2785,-0.26669,-0.25485,-0.24295,-0.23105,-0.21909,-0.20709,-0.19507,-0.18301,-0.17093,-0.15884,-0.1467,-0.13455,-0.12241,-0.1102,-0.097992,-0.085785,-0.073547,-0.06131,-0.049042,-0.036804,-0.024536,-0.012268,0,0.012268
-};
+static constexpr maxiTable<double, 514, maxiSineShape<512> > sineBuffer {};
 
 // This is a transition table that helps with bandlimited oscs.
-double transition[1001]={-0.500003,-0.500003,-0.500023,-0.500063,-0.500121,-0.500179,-0.500259,
-	-0.50036,-0.500476,-0.500591,-0.500732,-0.500893,-0.501066,-0.501239,
-	-0.50144,-0.501661,-0.501891,-0.502123,-0.502382,-0.502662,-0.502949,
-	-0.50324,-0.503555,-0.503895,-0.504238,-0.504587,-0.504958,-0.505356,
-	-0.505754,-0.506162,-0.506589,-0.507042,-0.507495,-0.50796,-0.508444,
-	-0.508951,-0.509458,-0.509979,-0.510518,-0.511079,-0.511638,-0.512213,
-	-0.512808,-0.51342,-0.51403,-0.514659,-0.515307,-0.51597,-0.51663,-0.517312,
-	-0.518012,-0.518724,-0.519433,-0.520166,-0.520916,-0.521675,-0.522432,
-	-0.523214,-0.524013,-0.524819,-0.525624,-0.526451,-0.527298,-0.528147,
-	-0.528999,-0.52987,-0.530762,-0.531654,-0.532551,-0.533464,-0.534399,
-	-0.535332,-0.536271,-0.537226,-0.538202,-0.539172,-0.540152,-0.541148,
-	-0.542161,-0.543168,-0.544187,-0.54522,-0.546269,-0.54731,-0.548365,
-	-0.549434,-0.550516,-0.55159,-0.552679,-0.553781,-0.554893,-0.555997,
-	-0.557118,-0.558252,-0.559391,-0.560524,-0.561674,-0.562836,-0.564001,
-	-0.565161,-0.566336,-0.567524,-0.568712,-0.569896,-0.571095,-0.572306,
-	-0.573514,-0.574721,-0.575939,-0.577171,-0.578396,-0.579622,-0.580858,
-	-0.582108,-0.583348,-0.58459,-0.585842,-0.587106,-0.588358,-0.589614,
-	-0.590879,-0.592154,-0.593415,-0.594682,-0.595957,-0.59724,-0.598507,
-	-0.599782,-0.601064,-0.602351,-0.603623,-0.604902,-0.606189,-0.607476,
-	-0.60875,-0.610032,-0.611319,-0.612605,-0.613877,-0.615157,-0.616443,
-	-0.617723,-0.618992,-0.620268,-0.621548,-0.62282,-0.624083,-0.62535,
-	-0.626622,-0.627882,-0.629135,-0.630391,-0.631652,-0.632898,-0.634138,
-	-0.63538,-0.636626,-0.637854,-0.639078,-0.640304,-0.641531,-0.642739,
-	-0.643943,-0.645149,-0.646355,-0.647538,-0.64872,-0.649903,-0.651084,
-	-0.652241,-0.653397,-0.654553,-0.655705,-0.656834,-0.657961,-0.659087,
-	-0.660206,-0.661304,-0.662399,-0.663492,-0.664575,-0.665639,-0.666699,
-	-0.667756,-0.6688,-0.669827,-0.670849,-0.671866,-0.672868,-0.673854,
-	-0.674835,-0.675811,-0.676767,-0.677709,-0.678646,-0.679576,-0.680484,
-	-0.68138,-0.682269,-0.683151,-0.684008,-0.684854,-0.685693,-0.686524,
-	-0.687327,-0.688119,-0.688905,-0.689682,-0.690428,-0.691164,-0.691893,
-	-0.692613,-0.6933,-0.693978,-0.694647,-0.695305,-0.695932,-0.696549,
-	-0.697156,-0.697748,-0.698313,-0.698865,-0.699407,-0.699932,-0.700431,
-	-0.700917,-0.701391,-0.701845,-0.702276,-0.702693,-0.703097,-0.703478,
-	-0.703837,-0.704183,-0.704514,-0.704819,-0.705105,-0.705378,-0.705633,
-	-0.70586,-0.706069,-0.706265,-0.706444,-0.706591,-0.706721,-0.706837,
-	-0.706938,-0.707003,-0.707051,-0.707086,-0.707106,-0.707086,-0.707051,
-	-0.707001,-0.706935,-0.706832,-0.706711,-0.706576,-0.706421,-0.706233,
-	-0.706025,-0.705802,-0.705557,-0.705282,-0.704984,-0.704671,-0.704334,
-	-0.703969,-0.703582,-0.703176,-0.702746,-0.702288,-0.70181,-0.701312,
-	-0.700785,-0.700234,-0.699664,-0.69907,-0.698447,-0.6978,-0.697135,
-	-0.696446,-0.695725,-0.694981,-0.694219,-0.693435,-0.692613,-0.691771,
-	-0.690911,-0.69003,-0.689108,-0.688166,-0.687206,-0.686227,-0.685204,
-	-0.684162,-0.683101,-0.682019,-0.680898,-0.679755,-0.678592,-0.677407,
-	-0.676187,-0.674941,-0.673676,-0.672386,-0.671066,-0.669718,-0.66835,
-	-0.666955,-0.665532,-0.664083,-0.662611,-0.661112,-0.659585,-0.658035,
-	-0.656459,-0.654854,-0.653223,-0.651572,-0.649892,-0.648181,-0.646446,
-	-0.644691,-0.642909,-0.641093,-0.639253,-0.637393,-0.63551,-0.633588,
-	-0.631644,-0.62968,-0.627695,-0.625668,-0.623621,-0.621553,-0.619464,
-	-0.617334,-0.615183,-0.613011,-0.610817,-0.608587,-0.606333,-0.604058,
-	-0.60176,-0.599429,-0.597072,-0.594695,-0.592293,-0.589862,-0.587404,
-	-0.584925,-0.58242,-0.579888,-0.577331,-0.574751,-0.572145,-0.569512,
-	-0.566858,-0.564178,-0.561471,-0.558739,-0.555988,-0.553209,-0.550402,
-	-0.547572,-0.544723,-0.54185,-0.538944,-0.536018,-0.533072,-0.530105,
-	-0.527103,-0.524081,-0.52104,-0.51798,-0.514883,-0.511767,-0.508633,
-	-0.505479,-0.502291,-0.499083,-0.495857,-0.492611,-0.489335,-0.486037,
-	-0.48272,-0.479384,-0.476021,-0.472634,-0.46923,-0.465805,-0.462356,
-	-0.458884,-0.455394,-0.451882,-0.448348,-0.444795,-0.44122,-0.437624,
-	-0.434008,-0.430374,-0.426718,-0.423041,-0.419344,-0.415631,-0.411897,
-	-0.40814,-0.404365,-0.400575,-0.396766,-0.392933,-0.389082,-0.385217,
-	-0.381336,-0.377428,-0.373505,-0.369568,-0.365616,-0.361638,-0.357645,
-	-0.353638,-0.349617,-0.345572,-0.341512,-0.337438,-0.33335,-0.329242,
-	-0.325118,-0.32098,-0.316829,-0.31266,-0.308474,-0.304276,-0.300063,
-	-0.295836,-0.291593,-0.287337,-0.283067,-0.278783,-0.274487,-0.270176,
-	-0.265852,-0.261515,-0.257168,-0.252806,-0.248431,-0.244045,-0.239649,
-	-0.23524,-0.230817,-0.226385,-0.221943,-0.21749,-0.213024,-0.208548,
-	-0.204064,-0.199571,-0.195064,-0.190549,-0.186026,-0.181495,-0.176952,
-	-0.1724,-0.167842,-0.163277,-0.1587,-0.154117,-0.149527,-0.14493,-0.140325,
-	-0.135712,-0.131094,-0.12647,-0.121839,-0.117201,-0.112559,-0.10791,
-	-0.103257,-0.0985979,-0.0939343,-0.0892662,-0.0845935,-0.079917,-0.0752362,
-	-0.0705516,-0.0658635,-0.0611729,-0.0564786,-0.0517814,-0.0470818,-0.0423802,
-	-0.0376765,-0.0329703,-0.0282629,-0.0235542,-0.0188445,-0.0141335,-0.00942183,
-	-0.00470983,2.41979e-06,0.00471481,0.00942681,0.0141384,0.0188494,0.023559,
-	0.028268,0.0329754,0.0376813,0.0423851,0.0470868,0.0517863,0.0564836,
-	0.0611777,0.0658683,0.0705566,0.0752412,0.0799218,0.0845982,0.0892712,
-	0.0939393,0.0986028,0.103262,0.107915,0.112563,0.117206,0.121844,0.126475,
-	0.131099,0.135717,0.14033,0.144935,0.149531,0.154122,0.158705,0.163281,
-	0.167847,0.172405,0.176956,0.1815,0.18603,0.190553,0.195069,0.199576,
-	0.204068,0.208552,0.213028,0.217495,0.221947,0.226389,0.230822,0.235245,
-	0.239653,0.244049,0.248436,0.252811,0.257173,0.26152,0.265857,0.270181,
-	0.274491,0.278788,0.283071,0.287341,0.291597,0.29584,0.300068,0.30428,
-	0.308478,0.312664,0.316833,0.320984,0.325122,0.329246,0.333354,0.337442,
-	0.341516,0.345576,0.34962,0.353642,0.357649,0.361642,0.36562,0.369572,
-	0.373509,0.377432,0.38134,0.385221,0.389086,0.392936,0.39677,0.400579,
-	0.404369,0.408143,0.4119,0.415634,0.419347,0.423044,0.426721,0.430377,
-	0.434011,0.437627,0.441223,0.444798,0.448351,0.451885,0.455397,0.458887,
-	0.462359,0.465807,0.469232,0.472637,0.476024,0.479386,0.482723,0.486039,
-	0.489338,0.492613,0.49586,0.499086,0.502294,0.505481,0.508635,0.511769,
-	0.514885,0.517982,0.521042,0.524083,0.527105,0.530107,0.533074,0.53602,
-	0.538946,0.541851,0.544725,0.547574,0.550404,0.553211,0.555989,0.55874,
-	0.561472,0.564179,0.566859,0.569514,0.572146,0.574753,0.577332,0.579889,
-	0.582421,0.584926,0.587405,0.589863,0.592294,0.594696,0.597073,0.59943,
-	0.60176,0.604059,0.606333,0.608588,0.610818,0.613012,0.615183,0.617335,
-	0.619464,0.621553,0.623621,0.625669,0.627696,0.629681,0.631645,0.633588,
-	0.63551,0.637393,0.639253,0.641093,0.642909,0.644691,0.646446,0.648181,
-	0.649892,0.651572,0.653223,0.654854,0.656459,0.658035,0.659585,0.661112,
-	0.662611,0.664083,0.665532,0.666955,0.66835,0.669718,0.671066,0.672386,
-	0.673676,0.674941,0.676187,0.677407,0.678592,0.679755,0.680898,0.682019,
-	0.683101,0.684162,0.685204,0.686227,0.687206,0.688166,0.689108,0.69003,
-	0.690911,0.691771,0.692613,0.693435,0.694219,0.694981,0.695725,0.696447,
-	0.697135,0.6978,0.698447,0.69907,0.699664,0.700234,0.700786,0.701312,
-	0.70181,0.702288,0.702746,0.703177,0.703582,0.703969,0.704334,0.704671,
-	0.704984,0.705282,0.705557,0.705802,0.706025,0.706233,0.706422,0.706576,
-	0.706712,0.706832,0.706936,0.707002,0.707051,0.707086,0.707106,0.707086,
-	0.707051,0.707003,0.706939,0.706838,0.706721,0.706592,0.706445,0.706265,
-	0.70607,0.705861,0.705634,0.705378,0.705105,0.70482,0.704515,0.704184,
-	0.703837,0.703478,0.703097,0.702694,0.702276,0.701846,0.701392,0.700917,
-	0.700432,0.699932,0.699408,0.698866,0.698314,0.697749,0.697156,0.696549,
-	0.695933,0.695305,0.694648,0.693979,0.693301,0.692613,0.691894,0.691165,
-	0.690428,0.689683,0.688905,0.68812,0.687327,0.686525,0.685693,0.684854,
-	0.684009,0.683152,0.68227,0.68138,0.680485,0.679577,0.678647,0.67771,
-	0.676768,0.675811,0.674836,0.673855,0.672869,0.671867,0.670849,0.669827,
-	0.668801,0.667757,0.6667,0.66564,0.664576,0.663493,0.6624,0.661305,
-	0.660207,0.659088,0.657962,0.656834,0.655705,0.654553,0.653398,0.652241,
-	0.651085,0.649903,0.648721,0.647539,0.646356,0.645149,0.643944,0.642739,
-	0.641532,0.640304,0.639079,0.637855,0.636626,0.635381,0.634139,0.632899,
-	0.631652,0.630392,0.629136,0.627883,0.626622,0.62535,0.624083,0.62282,
-	0.621548,0.620268,0.618993,0.617724,0.616443,0.615158,0.613878,0.612605,
-	0.61132,0.610032,0.608751,0.607477,0.606189,0.604903,0.603623,0.602351,
-	0.601065,0.599782,0.598508,0.59724,0.595957,0.594682,0.593415,0.592154,
-	0.59088,0.589615,0.588359,0.587106,0.585843,0.584591,0.583349,0.582108,
-	0.580859,0.579623,0.578397,0.577172,0.575939,0.574721,0.573515,0.572307,
-	0.571095,0.569897,0.568713,0.567525,0.566337,0.565161,0.564002,0.562837,
-	0.561674,0.560525,0.559392,0.558252,0.557119,0.555998,0.554893,0.553782,
-	0.552679,0.55159,0.550516,0.549434,0.548365,0.54731,0.546269,0.54522,
-	0.544187,0.543168,0.542161,0.541148,0.540153,0.539173,0.538202,0.537226,
-	0.536271,0.535332,0.5344,0.533464,0.532551,0.531654,0.530762,0.52987,
-	0.528999,0.528147,0.527298,0.526451,0.525624,0.524819,0.524014,0.523214,
-	0.522432,0.521675,0.520916,0.520166,0.519433,0.518724,0.518012,0.517312,
-	0.51663,0.51597,0.515307,0.51466,0.51403,0.51342,0.512808,0.512213,
-	0.511638,0.511079,0.510518,0.509979,0.509458,0.508951,0.508444,0.50796,
-	0.507495,0.507042,0.506589,0.506162,0.505754,0.505356,0.504958,0.504587,
-	0.504237,0.503895,0.503555,0.50324,0.502949,0.502662,0.502382,0.502123,
-	0.501891,0.501661,0.50144,0.501239,0.501066,0.500893,0.500732,0.500591,
-	0.500476,0.50036,0.500259,0.500179,0.500121,0.500063,0.500023,0.500003,0.500003};
+static constexpr maxiTable<double, 1001, maxiTransitionShape<1001> > transition {};
 
 //This is a lookup table for converting midi to frequency
-double mtofarray[129]={0, 8.661957, 9.177024, 9.722718, 10.3, 10.913383, 11.562325, 12.25, 12.978271, 13.75, 14.567617, 15.433853, 16.351599, 17.323914, 18.354048, 19.445436, 20.601723, 21.826765, 23.124651, 24.5, 25.956543, 27.5, 29.135235, 30.867706, 32.703197, 34.647827, 36.708096, 38.890873, 41.203445, 43.65353, 46.249302, 49., 51.913086, 55., 58.27047, 61.735413, 65.406395, 69.295654, 73.416191, 77.781746, 82.406891, 87.30706, 92.498604, 97.998856, 103.826172, 110., 116.540939, 123.470825, 130.81279, 138.591309, 146.832382, 155.563492, 164.813782, 174.61412, 184.997208, 195.997711, 207.652344, 220., 233.081879, 246.94165, 261.62558, 277.182617,293.664764, 311.126984, 329.627563, 349.228241, 369.994415, 391.995422, 415.304688, 440., 466.163757, 493.883301, 523.25116, 554.365234, 587.329529, 622.253967, 659.255127, 698.456482, 739.988831, 783.990845, 830.609375, 880., 932.327515, 987.766602, 1046.502319, 1108.730469, 1174.659058, 1244.507935, 1318.510254, 1396.912964, 1479.977661, 1567.981689, 1661.21875, 1760., 1864.655029, 1975.533203, 2093.004639, 2217.460938, 2349.318115, 2489.015869, 2637.020508, 2793.825928, 2959.955322, 3135.963379, 3322.4375, 3520., 3729.31, 3951.066406, 4186.009277, 4434.921875, 4698.63623, 4978.031738, 5274.041016, 5587.651855, 5919.910645, 6271.926758, 6644.875, 7040., 7458.620117, 7902.132812, 8372.018555, 8869.84375, 9397.272461, 9956.063477, 10548.082031, 11175.303711, 11839.821289, 12543.853516, 13289.75};
+static constexpr maxiTable<double, 129, maxiMtofShape> mtofarray {};
 
 void setup();//use this to do any initialisation if you want.
 
 void play(double *channels);//run dac!
 
+uint64_t maxiRandom::nextDefaultSeed() {
+	static std::atomic<uint64_t> count(0);
+	return 0x853c49e6748fea9bULL + count++;
+}
+
+void maxiRandom::setSeed(uint64_t seed) {
+	//splitmix64 spreads any seed, even 0, over the whole state
+	for (int i = 0; i < 2; i++) {
+		uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		z ^= z >> 31;
+		state[i * 2] = (uint32_t) z;
+		state[i * 2 + 1] = (uint32_t) (z >> 32);
+	}
+	for (int i = 0; i < 7; i++) pinkState[i] = 0.f;
+	spareGaussian = 0.f;
+	haveSpareGaussian = false;
+}
+
+float maxiRandom::gaussian() {
+	//Box-Muller, which makes two at a time
+	if (haveSpareGaussian) {
+		haveSpareGaussian = false;
+		return spareGaussian;
+	}
+	const float radius = sqrtf(-2.f * logf(1.f - uniform()));
+	const float angle = (float) TWOPI * uniform();
+	spareGaussian = radius * sinf(angle);
+	haveSpareGaussian = true;
+	return radius * cosf(angle);
+}
+
+float maxiRandom::pink() {
+	//Paul Kellet's filter, accurate to within 0.05dB above 9.2Hz at 44.1kHz
+	const float white = bipolar();
+	float *b = pinkState;
+	b[0] = 0.99886f * b[0] + white * 0.0555179f;
+	b[1] = 0.99332f * b[1] + white * 0.0750759f;
+	b[2] = 0.96900f * b[2] + white * 0.1538520f;
+	b[3] = 0.86650f * b[3] + white * 0.3104856f;
+	b[4] = 0.55000f * b[4] + white * 0.5329522f;
+	b[5] = -0.7616f * b[5] - white * 0.0168980f;
+	const float output = b[0] + b[1] + b[2] + b[3] + b[4] + b[5] + b[6] + white * 0.5362f;
+	b[6] = white * 0.115926f;
+	return output * 0.11f;
+}
+
+void maxiRandom::uniform(float *output, int numSamples) {
+	for (int i = 0; i < numSamples; i++) {
+		output[i] = uniform();
+	}
+}
+
+void maxiRandom::bipolar(float *output, int numSamples) {
+	for (int i = 0; i < numSamples; i++) {
+		output[i] = bipolar();
+	}
+}
+
+void maxiRandom::gaussian(float *output, int numSamples) {
+	for (int i = 0; i < numSamples; i++) {
+		output[i] = gaussian();
+	}
+}
+
+void maxiRandom::pink(float *output, int numSamples) {
+	for (int i = 0; i < numSamples; i++) {
+		output[i] = pink();
+	}
+}
+
 maxiOsc::maxiOsc(){
 	//When you create an oscillator, the constructor sets the phase of the oscillator to 0.
 	phase = 0.0;
@@ -211,8 +150,7 @@ maxiOsc::maxiOsc(){
 double maxiOsc::noise() {
 	//White Noise
 	//always the same unless you seed it.
-	float r = rand()/(float)RAND_MAX;
-	output=r*2-1;
+	output=random.bipolar();
 	return(output);
 }
 
@@ -226,16 +164,35 @@ double maxiOsc::sinewave(double frequency) {
 	//This is a sinewave oscillator
 	output=sin (phase*(TWOPI));
 	if ( phase >= 1.0 ) phase -= 1.0;
-	phase += (1./(maxiSettings::sampleRate/(frequency)));
+	phase += (frequency * context->sampleDuration);
 	return(output);
 
 }
 
+//sin(2*PI*x) for a buffer of phases measured in cycles, done in place.
+static inline void sinCycles(float *buf, int numSamples) {
+	for (int i = 0; i < numSamples; i++) {
+		buf[i] = maxiFastMath::sinCycle(buf[i]);
+	}
+}
+
+void maxiOsc::sinewave(float *output, int numSamples, double frequency) {
+	//Same phase walk as sinewave(frequency), then one pass of the sine kernel over the block.
+	const double phaseInc = (frequency * context->sampleDuration);
+	for (int i = 0; i < numSamples; i++) {
+		output[i] = (float) (phase - (long) phase); //keep float precision if the phase runs negative
+		if ( phase >= 1.0 ) phase -= 1.0;
+		phase += phaseInc;
+	}
+	sinCycles(output, numSamples);
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
 double maxiOsc::sinebuf4(double frequency) {
 	//This is a sinewave oscillator that uses 4 point interpolation on a 514 point buffer
 	double remainder;
 	double a,b,c,d,a1,a2,a3;
-	phase += 512./(maxiSettings::sampleRate/(frequency));
+	phase += 512. * frequency * context->sampleDuration;
 	if ( phase >= 511 ) phase -=512;
 	remainder = phase - floor(phase);
 
@@ -263,7 +220,7 @@ double maxiOsc::sinebuf4(double frequency) {
 double maxiOsc::sinebuf(double frequency) { //specify the frequency of the oscillator in Hz / cps etc.
 											//This is a sinewave oscillator that uses linear interpolation on a 514 point buffer
 	double remainder;
-	phase += 512./(maxiSettings::sampleRate/(frequency*chandiv));
+	phase += 512. * frequency * chandiv * context->sampleDuration;
 	if ( phase >= 511 ) phase -=512;
 	remainder = phase - floor(phase);
 	output = (double) ((1-remainder) * sineBuffer[1+ (long) phase] + remainder * sineBuffer[2+(long) phase]);
@@ -274,7 +231,7 @@ double maxiOsc::coswave(double frequency) {
 	//This is a cosine oscillator
 	output=cos (phase*(TWOPI));
 	if ( phase >= 1.0 ) phase -= 1.0;
-	phase += (1./(maxiSettings::sampleRate/(frequency)));
+	phase += (frequency * context->sampleDuration);
 	return(output);
 
 }
@@ -283,7 +240,7 @@ double maxiOsc::phasor(double frequency) {
 	//This produces a floating point linear ramp between 0 and 1 at the desired frequency
 	output=phase;
 	if ( phase >= 1.0 ) phase -= 1.0;
-	phase += (1./(maxiSettings::sampleRate/(frequency)));
+	phase += (frequency * context->sampleDuration);
 	return(output);
 }
 
@@ -292,7 +249,7 @@ double maxiOsc::square(double frequency) {
 	if (phase<0.5) output=-1;
 	if (phase>0.5) output=1;
 	if ( phase >= 1.0 ) phase -= 1.0;
-	phase += (1./(maxiSettings::sampleRate/(frequency)));
+	phase += (frequency * context->sampleDuration);
 	return(output);
 }
 
@@ -301,7 +258,7 @@ double maxiOsc::pulse(double frequency, double duty) {
 	if (duty<0.) duty=0;
 	if (duty>1.) duty=1;
 	if ( phase >= 1.0 ) phase -= 1.0;
-	phase += (1./(maxiSettings::sampleRate/(frequency)));
+	phase += (frequency * context->sampleDuration);
 	if (phase<duty) output=-1.;
 	if (phase>duty) output=1.;
 	return(output);
@@ -309,7 +266,7 @@ double maxiOsc::pulse(double frequency, double duty) {
 double maxiOsc::impulse(double frequency) {
     //this is an impulse generator
     if ( phase >= 1.0 ) phase -= 1.0;
-    double phaseInc = (1./(maxiSettings::sampleRate/(frequency)));
+    double phaseInc = (frequency * context->sampleDuration);
     double output = phase < phaseInc ? 1.0 : 0.0;
     phase += phaseInc;
     return output;
@@ -322,7 +279,7 @@ double maxiOsc::phasor(double frequency, double startphase, double endphase) {
 		phase=startphase;
 	}
 	if ( phase >= endphase ) phase = startphase;
-	phase += ((endphase-startphase)/(maxiSettings::sampleRate/(frequency)));
+	phase += ((endphase-startphase) * frequency * context->sampleDuration);
 	return(output);
 }
 
@@ -331,7 +288,7 @@ double maxiOsc::saw(double frequency) {
 	//Sawtooth generator. This is like a phasor but goes between -1 and 1
 	output=phase;
 	if ( phase >= 1.0 ) phase -= 2.0;
-	phase += (1./(maxiSettings::sampleRate/(frequency))) * 2.0;
+	phase += (frequency * context->sampleDuration) * 2.0;
 	return(output);
 
 }
@@ -339,7 +296,7 @@ double maxiOsc::saw(double frequency) {
 double maxiOsc::sawn(double frequency) {
 	//Bandlimited sawtooth generator. Woohoo.
 	if ( phase >= 0.5 ) phase -= 1.0;
-	phase += (1./(maxiSettings::sampleRate/(frequency)));
+	phase += (frequency * context->sampleDuration);
 	double temp=(8820.22/frequency)*phase;
 	if (temp<-0.5) {
 		temp=-0.5;
@@ -363,7 +320,7 @@ double maxiOsc::rect(double frequency, double duty) {
 double maxiOsc::triangle(double frequency) {
 	//This is a triangle wave.
 	if ( phase >= 1.0 ) phase -= 1.0;
-	phase += (1./(maxiSettings::sampleRate/(frequency)));
+	phase += (frequency * context->sampleDuration);
 	if (phase <= 0.5 ) {
 		output =(phase - 0.25) * 4;
 	} else {
@@ -373,6 +330,687 @@ double maxiOsc::triangle(double frequency) {
 
 }
 
+//Phase walks for the block oscillators. They run the same recurrence as the per-sample methods, so the
+//phase finishes exactly where those would leave it, and store each sample's phase less offset as float
+//for a vectorised waveform pass over the block. Taking the offset off in double keeps the sign exact for
+//the comparisons in square and pulse. readThenStep is for the methods that output the phase before
+//advancing it, stepThenRead for the ones that advance first.
+static inline void readThenStep(double &phase, float *out, int numSamples, double phaseInc,
+								double wrapAt, double wrapBy, double offset = 0.0) {
+	for (int i = 0; i < numSamples; i++) {
+		out[i] = (float) (phase - offset);
+		if ( phase >= wrapAt ) phase -= wrapBy;
+		phase += phaseInc;
+	}
+}
+
+static inline void readThenStep(double &phase, float *out, const float *frequency, int numSamples, double incPerHz,
+								double wrapAt, double wrapBy, double offset = 0.0) {
+	for (int i = 0; i < numSamples; i++) {
+		out[i] = (float) (phase - offset);
+		if ( phase >= wrapAt ) phase -= wrapBy;
+		phase += frequency[i] * incPerHz;
+	}
+}
+
+static inline void stepThenRead(double &phase, float *out, int numSamples, double phaseInc,
+								double wrapAt, double wrapBy, double offset = 0.0) {
+	for (int i = 0; i < numSamples; i++) {
+		if ( phase >= wrapAt ) phase -= wrapBy;
+		phase += phaseInc;
+		out[i] = (float) (phase - offset);
+	}
+}
+
+static inline void stepThenRead(double &phase, float *out, const float *frequency, int numSamples, double incPerHz,
+								double wrapAt, double wrapBy, double offset = 0.0) {
+	for (int i = 0; i < numSamples; i++) {
+		if ( phase >= wrapAt ) phase -= wrapBy;
+		phase += frequency[i] * incPerHz;
+		out[i] = (float) (phase - offset);
+	}
+}
+
+//Waveform passes, all done in place on the buffer of phases.
+static inline void cosCycles(float *buf, int numSamples) {
+	for (int i = 0; i < numSamples; i++) {
+		buf[i] = maxiFastMath::sinCycle(buf[i] + 0.25f);
+	}
+}
+
+static inline void triangles(float *buf, int numSamples) {
+	for (int i = 0; i < numSamples; i++) {
+		const float p = buf[i];
+		buf[i] = (p <= 0.5f ? p - 0.25f : 0.75f - p) * 4.f;
+	}
+}
+
+//phase - edge in, -1 before the edge and 1 after it. The per-sample versions hold their previous
+//output when the phase lands exactly on the edge, which below Nyquist is always -1.
+static inline void edges(float *buf, int numSamples) {
+	for (int i = 0; i < numSamples; i++) {
+		buf[i] = buf[i] > 0.f ? 1.f : -1.f;
+	}
+}
+
+static inline void sineBufferLinear(float *buf, int numSamples) {
+	for (int i = 0; i < numSamples; i++) {
+		const float p = buf[i];
+		const int index = (int) p;
+		const float remainder = p - floorf(p);
+		buf[i] = (float) ((1.f - remainder) * sineBuffer[1 + index] + remainder * sineBuffer[2 + index]);
+	}
+}
+
+static inline void sineBufferCubic(float *buf, int numSamples) {
+	for (int i = 0; i < numSamples; i++) {
+		const float p = buf[i];
+		const int index = (int) p;
+		const float remainder = p - floorf(p);
+		//the per-sample version reads in front of the table for the first point, this wraps round
+		const float a = (float) sineBuffer[index == 0 ? 511 : index - 1];
+		const float b = (float) sineBuffer[index];
+		const float c = (float) sineBuffer[index + 1];
+		const float d = (float) sineBuffer[index + 2];
+		const float a1 = 0.5f * (c - a);
+		const float a2 = a - 2.5f * b + 2.f * c - 0.5f * d;
+		const float a3 = 0.5f * (d - a) + 1.5f * (b - c);
+		buf[i] = ((a3 * remainder + a2) * remainder + a1) * remainder + b;
+	}
+}
+
+//transitionScale is 8820.22 * 1000 / frequency, one value for the whole block or one per sample.
+static inline float sawnSample(float phase, float transitionScale) {
+	const float temp = std::min(std::max(transitionScale * phase, -500.f), 500.f) + 500.f;
+	const int index = std::min((int) temp, 999);
+	const float remainder = temp - index;
+	return (float) ((1.f - remainder) * transition[index] + remainder * transition[index + 1]) - phase;
+}
+
+void maxiOsc::sinewave(float *output, const float *frequency, int numSamples) {
+	readThenStep(phase, output, frequency, numSamples, context->sampleDuration, 1.0, 1.0);
+	sinCycles(output, numSamples);
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiOsc::coswave(float *output, int numSamples, double frequency) {
+	readThenStep(phase, output, numSamples, (frequency * context->sampleDuration), 1.0, 1.0);
+	cosCycles(output, numSamples);
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiOsc::coswave(float *output, const float *frequency, int numSamples) {
+	readThenStep(phase, output, frequency, numSamples, context->sampleDuration, 1.0, 1.0);
+	cosCycles(output, numSamples);
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiOsc::phasor(float *output, int numSamples, double frequency) {
+	readThenStep(phase, output, numSamples, (frequency * context->sampleDuration), 1.0, 1.0);
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiOsc::phasor(float *output, const float *frequency, int numSamples) {
+	readThenStep(phase, output, frequency, numSamples, context->sampleDuration, 1.0, 1.0);
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiOsc::phasor(float *output, int numSamples, double frequency, double startphase, double endphase) {
+	//the ramp is the phase itself, so there is nothing to do after the walk
+	const double phaseInc = ((endphase-startphase) * frequency * context->sampleDuration);
+	for (int i = 0; i < numSamples; i++) {
+		output[i] = (float) phase;
+		if (phase<startphase) phase=startphase;
+		if ( phase >= endphase ) phase = startphase;
+		phase += phaseInc;
+	}
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiOsc::saw(float *output, int numSamples, double frequency) {
+	readThenStep(phase, output, numSamples, (frequency * context->sampleDuration) * 2.0, 1.0, 2.0);
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiOsc::saw(float *output, const float *frequency, int numSamples) {
+	readThenStep(phase, output, frequency, numSamples, 2. * context->sampleDuration, 1.0, 2.0);
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiOsc::triangle(float *output, int numSamples, double frequency) {
+	stepThenRead(phase, output, numSamples, (frequency * context->sampleDuration), 1.0, 1.0);
+	triangles(output, numSamples);
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiOsc::triangle(float *output, const float *frequency, int numSamples) {
+	stepThenRead(phase, output, frequency, numSamples, context->sampleDuration, 1.0, 1.0);
+	triangles(output, numSamples);
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiOsc::square(float *output, int numSamples, double frequency) {
+	readThenStep(phase, output, numSamples, (frequency * context->sampleDuration), 1.0, 1.0, 0.5);
+	edges(output, numSamples);
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiOsc::square(float *output, const float *frequency, int numSamples) {
+	readThenStep(phase, output, frequency, numSamples, context->sampleDuration, 1.0, 1.0, 0.5);
+	edges(output, numSamples);
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiOsc::pulse(float *output, int numSamples, double frequency, double duty) {
+	if (duty<0.) duty=0;
+	if (duty>1.) duty=1;
+	stepThenRead(phase, output, numSamples, (frequency * context->sampleDuration), 1.0, 1.0, duty);
+	edges(output, numSamples);
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiOsc::pulse(float *output, const float *frequency, int numSamples, double duty) {
+	if (duty<0.) duty=0;
+	if (duty>1.) duty=1;
+	stepThenRead(phase, output, frequency, numSamples, context->sampleDuration, 1.0, 1.0, duty);
+	edges(output, numSamples);
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiOsc::impulse(float *output, int numSamples, double frequency) {
+	//the comparison is all there is to it, so it's done during the walk
+	const double phaseInc = (frequency * context->sampleDuration);
+	for (int i = 0; i < numSamples; i++) {
+		if ( phase >= 1.0 ) phase -= 1.0;
+		output[i] = phase < phaseInc ? 1.f : 0.f;
+		phase += phaseInc;
+	}
+}
+
+void maxiOsc::impulse(float *output, const float *frequency, int numSamples) {
+	const double incPerHz = context->sampleDuration;
+	for (int i = 0; i < numSamples; i++) {
+		const double phaseInc = frequency[i] * incPerHz;
+		if ( phase >= 1.0 ) phase -= 1.0;
+		output[i] = phase < phaseInc ? 1.f : 0.f;
+		phase += phaseInc;
+	}
+}
+
+//sinebuf and sinebuf4 wrap after stepping rather than before, so they walk the phase themselves.
+void maxiOsc::sinebuf(float *output, int numSamples, double frequency) {
+	const double phaseInc = 512. * frequency * chandiv * context->sampleDuration;
+	for (int i = 0; i < numSamples; i++) {
+		phase += phaseInc;
+		if ( phase >= 511 ) phase -=512;
+		output[i] = (float) phase;
+	}
+	sineBufferLinear(output, numSamples);
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiOsc::sinebuf(float *output, const float *frequency, int numSamples) {
+	const double incPerHz = 512. * chandiv * context->sampleDuration;
+	for (int i = 0; i < numSamples; i++) {
+		phase += frequency[i] * incPerHz;
+		if ( phase >= 511 ) phase -=512;
+		output[i] = (float) phase;
+	}
+	sineBufferLinear(output, numSamples);
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiOsc::sinebuf4(float *output, int numSamples, double frequency) {
+	const double phaseInc = 512. * frequency * context->sampleDuration;
+	for (int i = 0; i < numSamples; i++) {
+		phase += phaseInc;
+		if ( phase >= 511 ) phase -=512;
+		output[i] = (float) phase;
+	}
+	sineBufferCubic(output, numSamples);
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiOsc::sinebuf4(float *output, const float *frequency, int numSamples) {
+	const double incPerHz = 512. * context->sampleDuration;
+	for (int i = 0; i < numSamples; i++) {
+		phase += frequency[i] * incPerHz;
+		if ( phase >= 511 ) phase -=512;
+		output[i] = (float) phase;
+	}
+	sineBufferCubic(output, numSamples);
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiOsc::sawn(float *output, int numSamples, double frequency) {
+	stepThenRead(phase, output, numSamples, (frequency * context->sampleDuration), 0.5, 1.0);
+	const float transitionScale = (float) (8820.22 / frequency * 1000.0);
+	for (int i = 0; i < numSamples; i++) {
+		output[i] = sawnSample(output[i], transitionScale);
+	}
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiOsc::sawn(float *output, const float *frequency, int numSamples) {
+	stepThenRead(phase, output, frequency, numSamples, context->sampleDuration, 0.5, 1.0);
+	for (int i = 0; i < numSamples; i++) {
+		output[i] = sawnSample(output[i], 8820220.f / frequency[i]);
+	}
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiOsc::noise(float *output, int numSamples) {
+	random.bipolar(output, numSamples);
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+
+//Two sample polynomial residuals of a unit step (BLEP) and of its integral (BLAMP). t is the phase in
+//cycles since the discontinuity and dt the phase increment. Both sides are worked out and selected
+//rather than branched on, so the block loops below vectorise.
+template <typename T> static inline T polyBlep(T t, T dt) {
+	const T a = t / dt;
+	const T b = (t - 1) / dt;
+	return t < dt ? a + a - a * a - 1 : (t > 1 - dt ? b * b + b + b + 1 : 0);
+}
+
+template <typename T> static inline T polyBlamp(T t, T dt) {
+	const T a = t / dt - 1;
+	const T b = (t - 1) / dt + 1;
+	return t < dt ? a * a * a * (T) (-1. / 3.) : (t > 1 - dt ? b * b * b * (T) (1. / 3.) : 0);
+}
+
+template <typename T> static inline T blSaw(T t, T dt) {
+	return t + t - 1 - polyBlep(t, dt);
+}
+
+template <typename T> static inline T blPulse(T t, T dt, T width) {
+	//keep the two edges far enough apart that their residuals don't overlap
+	width = std::min(std::max(width, dt + dt), 1 - dt - dt);
+	//high and fall come from the same sum so they agree even when it rounds onto the edge
+	const T sinceFall = t + 1 - width;
+	const bool high = sinceFall < 1;
+	return (high ? (T) 1 : (T) -1) + polyBlep(t, dt) - polyBlep(high ? sinceFall : sinceFall - 1, dt);
+}
+
+template <typename T> static inline T blTriangle(T t, T dt) {
+	//the slope changes by 8 per cycle at each corner
+	T peak = t + (T) 0.5;
+	peak = peak >= 1 ? peak - 1 : peak;
+	return (t < (T) 0.5 ? 4 * t - 1 : 3 - 4 * t) + 8 * dt * (polyBlamp(t, dt) - polyBlamp(peak, dt));
+}
+
+//phase increment for sample i, either the same for the whole block or incPerHz times its frequency
+template <bool perSample> static inline float blIncrement(const float *frequency, int i, float inc) {
+	return perSample ? frequency[i] * inc : inc;
+}
+
+//the waveform pass over a block of phases, done in place
+template <bool perSample>
+static void blWaveform(maxiBLOsc::waveTypes waveform, float *buf, int numSamples, const float *frequency,
+					   float inc, float width) {
+	switch (waveform) {
+		case maxiBLOsc::SAW:
+			for (int i = 0; i < numSamples; i++) {
+				buf[i] = blSaw(buf[i], blIncrement<perSample>(frequency, i, inc));
+			}
+			break;
+		case maxiBLOsc::SQUARE:
+			for (int i = 0; i < numSamples; i++) {
+				buf[i] = blPulse(buf[i], blIncrement<perSample>(frequency, i, inc), 0.5f);
+			}
+			break;
+		case maxiBLOsc::PULSE:
+			for (int i = 0; i < numSamples; i++) {
+				buf[i] = blPulse(buf[i], blIncrement<perSample>(frequency, i, inc), width);
+			}
+			break;
+		case maxiBLOsc::TRIANGLE:
+			for (int i = 0; i < numSamples; i++) {
+				buf[i] = blTriangle(buf[i], blIncrement<perSample>(frequency, i, inc));
+			}
+			break;
+	}
+}
+
+maxiBLOsc::maxiBLOsc() : phase(0.0), pulseWidth(0.5), waveform(SAW) {
+}
+
+void maxiBLOsc::phaseReset(double phaseIn) {
+	phase = phaseIn - floor(phaseIn);
+}
+
+double maxiBLOsc::play(double frequency) {
+	//frequency should be between 0 and Nyquist
+	const double phaseInc = (frequency * context->sampleDuration);
+	double output;
+	switch (waveform) {
+		case SAW: output = blSaw(phase, phaseInc); break;
+		case SQUARE: output = blPulse(phase, phaseInc, 0.5); break;
+		case PULSE: output = blPulse(phase, phaseInc, pulseWidth); break;
+		default: output = blTriangle(phase, phaseInc); break;
+	}
+	phase += phaseInc;
+	if ( phase >= 1.0 ) phase -= 1.0;
+	return(output);
+}
+
+void maxiBLOsc::play(float *output, int numSamples, double frequency) {
+	const double phaseInc = (frequency * context->sampleDuration);
+	for (int i = 0; i < numSamples; i++) {
+		output[i] = (float) phase;
+		phase += phaseInc;
+		if ( phase >= 1.0 ) phase -= 1.0;
+	}
+	blWaveform<false>(waveform, output, numSamples, nullptr, (float) phaseInc, (float) pulseWidth);
+}
+
+void maxiBLOsc::play(float *output, const float *frequency, int numSamples) {
+	const double incPerHz = context->sampleDuration;
+	for (int i = 0; i < numSamples; i++) {
+		output[i] = (float) phase;
+		phase += frequency[i] * incPerHz;
+		if ( phase >= 1.0 ) phase -= 1.0;
+	}
+	blWaveform<true>(waveform, output, numSamples, frequency, (float) incPerHz, (float) pulseWidth);
+}
+
+
+//Waveforms for maxiFixedPointOsc, each takes the accumulator. Read as signed it is the phase in
+//-0.5 to 0.5 cycles, which converts to float in one instruction.
+static const float fixedToCycles = 1.f / 4294967296.f;
+
+struct fixedSine {
+	float operator()(uint32_t p) const { return maxiFastMath::sinCycle((int32_t) p * fixedToCycles); }
+};
+
+struct fixedPhasor {
+	float operator()(uint32_t p) const { return (p >> 8) * (1.f / 16777216.f); }
+};
+
+struct fixedSaw {
+	float operator()(uint32_t p) const { return (int32_t) p * (1.f / 2147483648.f); }
+};
+
+struct fixedTriangle {
+	//folding the second half of the cycle back down is an xor with the sign
+	float operator()(uint32_t p) const { return ((p ^ (uint32_t) ((int32_t) p >> 31)) >> 7) * (1.f / 8388608.f) - 1.f; }
+};
+
+struct fixedPulse {
+	uint32_t edge;
+	float operator()(uint32_t p) const { return p < edge ? -1.f : 1.f; }
+};
+
+//the top 9 bits index the 512 point sineBuffer and the 23 below them are the fraction
+struct fixedSineBuffer {
+	float operator()(uint32_t p) const {
+		const uint32_t index = p >> 23;
+		const float remainder = (p & 0x7FFFFF) * (1.f / 8388608.f);
+		return (float) ((1.f - remainder) * sineBuffer[index] + remainder * sineBuffer[index + 1]);
+	}
+};
+
+struct fixedSineBuffer4 {
+	float operator()(uint32_t p) const {
+		const uint32_t index = p >> 23;
+		const float remainder = (p & 0x7FFFFF) * (1.f / 8388608.f);
+		const float a = (float) sineBuffer[(index - 1) & 511];
+		const float b = (float) sineBuffer[index];
+		const float c = (float) sineBuffer[index + 1];
+		const float d = (float) sineBuffer[index + 2];
+		const float a1 = 0.5f * (c - a);
+		const float a2 = a - 2.5f * b + 2.f * c - 0.5f * d;
+		const float a3 = 0.5f * (d - a) + 1.5f * (b - c);
+		return ((a3 * remainder + a2) * remainder + a1) * remainder + b;
+	}
+};
+
+static inline uint32_t pulseEdge(double duty) {
+	if (duty<0.) duty=0;
+	if (duty>1.) duty=1;
+	return (uint32_t) std::min(duty * 4294967296.0, 4294967295.0);
+}
+
+maxiFixedPointOsc::maxiFixedPointOsc() : phase(0), lastIncrement(0), lastFrequency(0), lastSampleDuration(0) {
+}
+
+void maxiFixedPointOsc::phaseReset(double phaseIn) {
+	phase = (uint32_t) (int64_t) floor((phaseIn - floor(phaseIn)) * 4294967296.0 + 0.5);
+}
+
+template <class Wave> void maxiFixedPointOsc::fill(float *output, int numSamples, double frequency, Wave wave) {
+	const uint32_t phaseInc = increment(frequency);
+	uint32_t p = phase;
+	for (int i = 0; i < numSamples; i++) {
+		output[i] = wave(p);
+		p += phaseInc;
+	}
+	phase = p;
+}
+
+template <class Wave> void maxiFixedPointOsc::fill(float *output, const float *frequency, int numSamples, Wave wave) {
+	//below Nyquist the increment fits in an int32, which converts from float in one instruction
+	const float incPerHz = (float) (4294967296.0 * context->sampleDuration);
+	uint32_t p = phase;
+	for (int i = 0; i < numSamples; i++) {
+		output[i] = wave(p);
+		p += (uint32_t) (int32_t) (frequency[i] * incPerHz);
+	}
+	phase = p;
+}
+
+double maxiFixedPointOsc::sinewave(double frequency) {
+	const double output = fixedSine()(phase);
+	phase += increment(frequency);
+	return(output);
+}
+
+double maxiFixedPointOsc::phasor(double frequency) {
+	//exact rather than through float
+	const double output = phase * (1.0 / 4294967296.0);
+	phase += increment(frequency);
+	return(output);
+}
+
+double maxiFixedPointOsc::saw(double frequency) {
+	const double output = (int32_t) phase * (1.0 / 2147483648.0);
+	phase += increment(frequency);
+	return(output);
+}
+
+double maxiFixedPointOsc::triangle(double frequency) {
+	const double output = fixedTriangle()(phase);
+	phase += increment(frequency);
+	return(output);
+}
+
+double maxiFixedPointOsc::square(double frequency) {
+	const double output = phase < 0x80000000u ? -1.0 : 1.0;
+	phase += increment(frequency);
+	return(output);
+}
+
+double maxiFixedPointOsc::pulse(double frequency, double duty) {
+	const double output = phase < pulseEdge(duty) ? -1.0 : 1.0;
+	phase += increment(frequency);
+	return(output);
+}
+
+double maxiFixedPointOsc::sinebuf(double frequency) {
+	const double output = fixedSineBuffer()(phase);
+	phase += increment(frequency);
+	return(output);
+}
+
+double maxiFixedPointOsc::sinebuf4(double frequency) {
+	const double output = fixedSineBuffer4()(phase);
+	phase += increment(frequency);
+	return(output);
+}
+
+void maxiFixedPointOsc::sinewave(float *output, int numSamples, double frequency) {
+	fill(output, numSamples, frequency, fixedSine());
+}
+
+void maxiFixedPointOsc::sinewave(float *output, const float *frequency, int numSamples) {
+	fill(output, frequency, numSamples, fixedSine());
+}
+
+void maxiFixedPointOsc::phasor(float *output, int numSamples, double frequency) {
+	fill(output, numSamples, frequency, fixedPhasor());
+}
+
+void maxiFixedPointOsc::phasor(float *output, const float *frequency, int numSamples) {
+	fill(output, frequency, numSamples, fixedPhasor());
+}
+
+void maxiFixedPointOsc::saw(float *output, int numSamples, double frequency) {
+	fill(output, numSamples, frequency, fixedSaw());
+}
+
+void maxiFixedPointOsc::saw(float *output, const float *frequency, int numSamples) {
+	fill(output, frequency, numSamples, fixedSaw());
+}
+
+void maxiFixedPointOsc::triangle(float *output, int numSamples, double frequency) {
+	fill(output, numSamples, frequency, fixedTriangle());
+}
+
+void maxiFixedPointOsc::triangle(float *output, const float *frequency, int numSamples) {
+	fill(output, frequency, numSamples, fixedTriangle());
+}
+
+void maxiFixedPointOsc::square(float *output, int numSamples, double frequency) {
+	fixedPulse wave = { 0x80000000u };
+	fill(output, numSamples, frequency, wave);
+}
+
+void maxiFixedPointOsc::square(float *output, const float *frequency, int numSamples) {
+	fixedPulse wave = { 0x80000000u };
+	fill(output, frequency, numSamples, wave);
+}
+
+void maxiFixedPointOsc::pulse(float *output, int numSamples, double frequency, double duty) {
+	fixedPulse wave = { pulseEdge(duty) };
+	fill(output, numSamples, frequency, wave);
+}
+
+void maxiFixedPointOsc::pulse(float *output, const float *frequency, int numSamples, double duty) {
+	fixedPulse wave = { pulseEdge(duty) };
+	fill(output, frequency, numSamples, wave);
+}
+
+void maxiFixedPointOsc::sinebuf(float *output, int numSamples, double frequency) {
+	fill(output, numSamples, frequency, fixedSineBuffer());
+}
+
+void maxiFixedPointOsc::sinebuf(float *output, const float *frequency, int numSamples) {
+	fill(output, frequency, numSamples, fixedSineBuffer());
+}
+
+void maxiFixedPointOsc::sinebuf4(float *output, int numSamples, double frequency) {
+	fill(output, numSamples, frequency, fixedSineBuffer4());
+}
+
+void maxiFixedPointOsc::sinebuf4(float *output, const float *frequency, int numSamples) {
+	fill(output, frequency, numSamples, fixedSineBuffer4());
+}
+
+
+//Waveforms for maxiUnison, t is the phase in cycles and dt the increment
+struct unisonSaw {
+	float operator()(float t, float dt) const { return blSaw(t, dt); }
+};
+
+struct unisonSquare {
+	float operator()(float t, float dt) const { return blPulse(t, dt, 0.5f); }
+};
+
+struct unisonTriangle {
+	float operator()(float t, float dt) const { return blTriangle(t, dt); }
+};
+
+struct unisonSine {
+	float operator()(float t, float) const { return maxiFastMath::sinCycle(t); }
+};
+
+//One copy added into the stereo block. The phase is an induction variable, so the loop vectorises
+//with samples in the lanes.
+template <class Wave>
+static inline uint32_t unisonVoice(float *left, float *right, int numSamples, uint32_t phase, uint32_t phaseInc,
+								   float gainLeft, float gainRight, Wave wave) {
+	const float dt = phaseInc * fixedToCycles;
+	for (int i = 0; i < numSamples; i++) {
+		const float x = wave((phase >> 8) * (1.f / 16777216.f), dt);
+		left[i] += x * gainLeft;
+		right[i] += x * gainRight;
+		phase += phaseInc;
+	}
+	return phase;
+}
+
+maxiUnison::maxiUnison() : waveform(SAW), numVoices(7), detune(20.0), spread(1.0), randomness(1.0) {
+	update();
+	retrigger();
+}
+
+void maxiUnison::setNumVoices(int newNumVoices) {
+	numVoices = std::min(std::max(newNumVoices, 1), (int) maxVoices);
+	update();
+}
+
+void maxiUnison::setDetune(double cents) {
+	detune = cents;
+	update();
+}
+
+void maxiUnison::setSpread(double width) {
+	spread = std::min(std::max(width, 0.0), 1.0);
+	update();
+}
+
+void maxiUnison::update() {
+	//copies from lowest to highest pitch, panned from left to right, equal power
+	const double level = 1.0 / sqrt((double) numVoices);
+	for (int v = 0; v < numVoices; v++) {
+		const double position = numVoices > 1 ? v * 2.0 / (numVoices - 1) - 1.0 : 0.0;
+		ratio[v] = pow(2.0, position * detune / 1200.0);
+		const double angle = (position * spread + 1.0) * PI / 4.0;
+		gainLeft[v] = (float) (cos(angle) * level);
+		gainRight[v] = (float) (sin(angle) * level);
+	}
+}
+
+void maxiUnison::retrigger() {
+	for (int v = 0; v < maxVoices; v++) {
+		phase[v] = (uint32_t) (random.next() * randomness);
+	}
+}
+
+void maxiUnison::play(float *left, float *right, int numSamples, double frequency) {
+	std::fill(left, left + numSamples, 0.f);
+	std::fill(right, right + numSamples, 0.f);
+
+	for (int v = 0; v < numVoices; v++) {
+		const uint32_t phaseInc = maxiFixedPointOsc::phaseIncrement(frequency * ratio[v], context->sampleRate);
+		switch (waveform) {
+			case SAW:
+				phase[v] = unisonVoice(left, right, numSamples, phase[v], phaseInc, gainLeft[v], gainRight[v], unisonSaw());
+				break;
+			case SQUARE:
+				phase[v] = unisonVoice(left, right, numSamples, phase[v], phaseInc, gainLeft[v], gainRight[v], unisonSquare());
+				break;
+			case TRIANGLE:
+				phase[v] = unisonVoice(left, right, numSamples, phase[v], phaseInc, gainLeft[v], gainRight[v], unisonTriangle());
+				break;
+			case SINE:
+				phase[v] = unisonVoice(left, right, numSamples, phase[v], phaseInc, gainLeft[v], gainRight[v], unisonSine());
+				break;
+		}
+	}
+}
+
 
 //double maxiEnvelope::line(int numberofsegments,double segments[1000]) {
 double maxiEnvelope::line(int numberofsegments,std::vector<double>& segments) {
@@ -383,9 +1021,9 @@ double maxiEnvelope::line(int numberofsegments,std::vector<double>& segments) {
 		nextval=segments[valindex+2];
 		currentval=segments[valindex];
 		if (currentval-amplitude > 0.0000001 && valindex < numberofsegments) {
-			amplitude += ((currentval-startval)/(maxiSettings::sampleRate/period));
+			amplitude += ((currentval-startval) * period * context->sampleDuration);
 		} else if (currentval-amplitude < -0.0000001 && valindex < numberofsegments) {
-			amplitude -= (((currentval-startval)*(-1))/(maxiSettings::sampleRate/period));
+			amplitude -= (((currentval-startval)*(-1)) * period * context->sampleDuration);
 		} else if (valindex >numberofsegments-1) {
 			valindex=numberofsegments-2;
 		} else {
@@ -452,18 +1090,35 @@ double maxiFilter::hipass(double input, double cutoff) {
 	outputs[0]=output;
 	return(output);
 }
+//lores and hires share their coefficients, which are only worked out again when the cutoff or
+//resonance change
+void maxiFilter::resonantCoefficients(double resonance) {
+	if (cutoff<10) cutoff=10;
+	if (cutoff>context->sampleRate) cutoff=context->sampleRate;
+	if (resonance<1.) resonance = 1.;
+	if (!resonant.update(cutoff*context->radiansPerHz, resonance)) return;
+	const double z=cos(cutoff*context->radiansPerHz);
+	resonant.value[0]=2-2*z;
+	resonant.value[1]=(sqrt(2.0)*sqrt(-pow((z-1.0),3.0))+resonance*(z-1))/(resonance*(z-1));
+}
+
+void maxiFilter::bandCoefficients(double resonance) {
+	if (cutoff>context->nyquist) cutoff=context->nyquist;
+	if (resonance>=1.) resonance=0.999999;
+	if (!band.update(cutoff*context->radiansPerHz, resonance)) return;
+	const double z=cos(cutoff*context->radiansPerHz);
+	band.value[0] = (1-resonance)*(sqrt(resonance*(resonance-4.0*pow(z,2.0)+2.0)+1));
+	band.value[1] = 2*z*resonance;
+	band.value[2] = pow((resonance*-1),2);
+}
+
 //awesome. cuttof is freq in hz. res is between 1 and whatever. Watch out!
 double maxiFilter::lores(double input,double cutoff1, double resonance) {
 	cutoff=cutoff1;
-	if (cutoff<10) cutoff=10;
-	if (cutoff>(maxiSettings::sampleRate)) cutoff=(maxiSettings::sampleRate);
-	if (resonance<1.) resonance = 1.;
-	z=cos(TWOPI*cutoff/maxiSettings::sampleRate);
-	c=2-2*z;
-	double r=(sqrt(2.0)*sqrt(-pow((z-1.0),3.0))+resonance*(z-1))/(resonance*(z-1));
-	x=x+(input-y)*c;
+	resonantCoefficients(resonance);
+	x=x+(input-y)*resonant.value[0];
 	y=y+x;
-	x=x*r;
+	x=x*resonant.value[1];
 	output=y;
 	return(output);
 }
@@ -471,15 +1126,10 @@ double maxiFilter::lores(double input,double cutoff1, double resonance) {
 //working hires filter
 double maxiFilter::hires(double input,double cutoff1, double resonance) {
 	cutoff=cutoff1;
-	if (cutoff<10) cutoff=10;
-	if (cutoff>(maxiSettings::sampleRate)) cutoff=(maxiSettings::sampleRate);
-	if (resonance<1.) resonance = 1.;
-	z=cos(TWOPI*cutoff/maxiSettings::sampleRate);
-	c=2-2*z;
-	double r=(sqrt(2.0)*sqrt(-pow((z-1.0),3.0))+resonance*(z-1))/(resonance*(z-1));
-	x=x+(input-y)*c;
+	resonantCoefficients(resonance);
+	x=x+(input-y)*resonant.value[0];
 	y=y+x;
-	x=x*r;
+	x=x*resonant.value[1];
 	output=input-y;
 	return(output);
 }
@@ -487,19 +1137,96 @@ double maxiFilter::hires(double input,double cutoff1, double resonance) {
 //This works a bit. Needs attention.
 double maxiFilter::bandpass(double input,double cutoff1, double resonance) {
 	cutoff=cutoff1;
-	if (cutoff>(maxiSettings::sampleRate*0.5)) cutoff=(maxiSettings::sampleRate*0.5);
-	if (resonance>=1.) resonance=0.999999;
-	z=cos(TWOPI*cutoff/maxiSettings::sampleRate);
-	inputs[0] = (1-resonance)*(sqrt(resonance*(resonance-4.0*pow(z,2.0)+2.0)+1));
-	inputs[1] = 2*z*resonance;
-	inputs[2] = pow((resonance*-1),2);
-
-	output=inputs[0]*input+inputs[1]*outputs[1]+inputs[2]*outputs[2];
+	bandCoefficients(resonance);
+	output=band.value[0]*input+band.value[1]*outputs[1]+band.value[2]*outputs[2];
 	outputs[2]=outputs[1];
 	outputs[1]=output;
 	return(output);
 }
 
+template <bool highpass>
+static inline void resonantBlock(float *output, const float *input, int numSamples, double &x, double &y,
+								 const double *from, const double *step) {
+	double c = from[0], r = from[1];
+	for (int i = 0; i < numSamples; i++) {
+		c += step[0];
+		r += step[1];
+		const double in = input[i];
+		x=x+(in-y)*c;
+		y=y+x;
+		x=x*r;
+		output[i] = (float) (highpass ? in-y : y);
+	}
+}
+
+void maxiFilter::lores(float *output, const float *input, int numSamples, double cutoff1, double resonance) {
+	cutoff=cutoff1;
+	resonantCoefficients(resonance);
+	double from[2], step[2];
+	resonant.glide(from, step, numSamples);
+	resonantBlock<false>(output, input, numSamples, x, y, from, step);
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiFilter::hires(float *output, const float *input, int numSamples, double cutoff1, double resonance) {
+	cutoff=cutoff1;
+	resonantCoefficients(resonance);
+	double from[2], step[2];
+	resonant.glide(from, step, numSamples);
+	resonantBlock<true>(output, input, numSamples, x, y, from, step);
+	if (numSamples > 0) this->output = output[numSamples - 1];
+}
+
+void maxiFilter::bandpass(float *output, const float *input, int numSamples, double cutoff1, double resonance) {
+	cutoff=cutoff1;
+	bandCoefficients(resonance);
+	double from[3], step[3];
+	band.glide(from, step, numSamples);
+	double y1 = outputs[1], y2 = outputs[2];
+	for (int i = 0; i < numSamples; i++) {
+		from[0] += step[0];
+		from[1] += step[1];
+		from[2] += step[2];
+		const double y0 = from[0]*input[i]+from[1]*y1+from[2]*y2;
+		y2 = y1;
+		y1 = y0;
+		output[i] = (float) y0;
+	}
+	outputs[1] = y1;
+	outputs[2] = y2;
+	if (numSamples > 0) this->output = y1;
+}
+
+void maxiSVF::play(float *output, const float *input, int numSamples, double lpmix, double bpmix, double hpmix, double notchmix) {
+	double from[5], step[5];
+	coefficients.glide(from, step, numSamples);
+	for (int i = 0; i < numSamples; i++) {
+		for (int c = 0; c < 5; c++) from[c] += step[c];
+		const double w = input[i];
+		const double v1z = v1;
+		const double v2z = v2;
+		const double v3 = w + v0z - 2.0 * v2z;
+		v1 += from[0]*v3-from[1]*v1z;
+		v2 += from[2]*v3+from[3]*v1z;
+		v0z = w;
+		const double high = w-from[4]*v1-v2;
+		const double notch = w-from[4]*v1;
+		output[i] = (float) ((v2 * lpmix) + (v1 * bpmix) + (high * hpmix) + (notch * notchmix));
+	}
+}
+
+void maxiBiquad::play(float *output, const float *input, int numSamples) {
+	double c[5], step[5];
+	coefficients.glide(c, step, numSamples);
+	for (int i = 0; i < numSamples; i++) {
+		for (int k = 0; k < 5; k++) c[k] += step[k];
+		v[0] = input[i] - (c[3] * v[1]) - (c[4] * v[2]);
+		output[i] = (float) ((c[0] * v[0]) + (c[1] * v[1]) + (c[2] * v[2]));
+		v[2] = v[1];
+		v[1] = v[0];
+	}
+}
+
 //stereo bus
 void maxiMix::stereo(double input,std::vector<double>&two,double x) {
 	if (x>1) x=1;
@@ -573,21 +1300,22 @@ int maxiSample::setSampleFromOggBlob(vector<unsigned char> &oggBlob, int channel
     printf("\n");
     myChannels=(short)channelx;
     mySampleRate=44100;
-    amplitudes.resize(myDataSize);
+    vector<float> decoded(myDataSize);
 
     if (myChannels>1) {
         int position=0;
         int channel=readChannel;
         for (int i=channel;i<myDataSize*2;i+=myChannels) {
-            amplitudes[position]=temp[i]/32767.0;
+            decoded[position]=temp[i]/32767.0;
             position++;
         }
     }else{
         for(int i=0; i < myDataSize; i++) {
-            amplitudes[i] = temp[i] / 32767.0;
+            decoded[i] = temp[i] / 32767.0;
         }
     }
     free(temp);
+    amplitudes = std::move(decoded);
 
     return result; // this should probably be something more descriptive
 #endif
@@ -604,7 +1332,7 @@ bool maxiSample::isReady(){
 }
 
 void maxiSample::setSample(vector<double>& sampleData){
-    amplitudes = sampleData;
+    amplitudes = vector<float>(sampleData.begin(), sampleData.end());
 	mySampleRate = 44100;
     position=amplitudes.size()-1;
 }
@@ -621,93 +1349,42 @@ void maxiSample::setSample(vector<double>& sampleData, int sampleRate){
 
 // -------------------------
 
+void maxiSample::setLength(unsigned long numSamples) {
+	vector<float> resized(numSamples, 0.f);
+	const unsigned long kept = min((unsigned long) amplitudes.size(), numSamples);
+	if (kept > 0) copy(amplitudes.data(), amplitudes.data() + kept, resized.begin());
+	amplitudes = std::move(resized);
+	position = min(position, (double) numSamples);
+	recordPosition = min(recordPosition, (double) numSamples);
+}
+
 //This sets the playback position to the start of a sample
 void maxiSample::trigger() {
 	position = 0;
 	recordPosition = 0;
 }
 
-//This is the main read function.
+//This is the main read function. It goes through maxiSamplePool, so a file that's already loaded
+//anywhere in the process is shared rather than read again.
 bool maxiSample::read()
 {
-    bool result;
-    ifstream inFile( myPath.c_str(), ios::in | ios::binary);
+    maxiSampleInfo info;
     cout << "Loading: " << myPath << endl;
-    result = inFile.is_open();
-    int myDataSize;
-    if (result) {
-        bool datafound = false;
-        inFile.seekg(4, ios::beg);
-        inFile.read( (char*) &myChunkSize, 4 ); // read the ChunkSize
-
-        inFile.seekg(16, ios::beg);
-        inFile.read( (char*) &mySubChunk1Size, 4 ); // read the SubChunk1Size
-
-        //inFile.seekg(20, ios::beg);
-        inFile.read( (char*) &myFormat, sizeof(short) ); // read the file format.  This should be 1 for PCM
-
-        //inFile.seekg(22, ios::beg);
-        inFile.read( (char*) &myChannels, sizeof(short) ); // read the # of channels (1 or 2)
-
-        //inFile.seekg(24, ios::beg);
-        inFile.read( (char*) &mySampleRate, sizeof(int) ); // read the samplerate
-
-        //inFile.seekg(28, ios::beg);
-        inFile.read( (char*) &myByteRate, sizeof(int) ); // read the byterate
-
-        //inFile.seekg(32, ios::beg);
-        inFile.read( (char*) &myBlockAlign, sizeof(short) ); // read the blockalign
-
-        //inFile.seekg(34, ios::beg);
-        inFile.read( (char*) &myBitsPerSample, sizeof(short) ); // read the bitspersample
-
-        //ignore any extra chunks
-        char chunkID[5]="";
-        chunkID[4] = 0;
-        int filePos = 20 + mySubChunk1Size;
-        while(!datafound && !inFile.eof()) {
-            inFile.seekg(filePos, ios::beg);
-            inFile.read((char*) &chunkID, sizeof(char) * 4);
-            inFile.seekg(filePos + 4, ios::beg);
-            inFile.read( (char*) &myDataSize, sizeof(int) ); // read the size of the data
-            filePos += 8;
-            if (strcmp(chunkID,"data") == 0) {
-                datafound = true;
-            }else{
-                filePos += myDataSize;
-            }
-        }
-
-        // read the data chunk
-        vector<short> shortAmps;
-        shortAmps.resize(myDataSize/2);
-        inFile.seekg(filePos, ios::beg);
-        inFile.read((char*)shortAmps.data(), myDataSize);
-        inFile.close(); // close the input file
-
-        if (myChannels>1) {
-            int position=0;
-            int channel=readChannel*2;
-            for (int i=channel;i<myDataSize+6;i+=(myChannels*2)) {
-                shortAmps[position]=shortAmps[i];
-                position++;
-            }
-        }
-        amplitudes.resize(shortAmps.size());
-        for(int i=0; i < shortAmps.size(); i++) {
-            amplitudes[i] = shortAmps[i] / 32767.0;
-        }
-        position = amplitudes.size();
-        cout << "Ch: " << myChannels << ", len: " << amplitudes.size() << endl;
-
-    }else {
+    if (!maxiSamplePool::load(myPath, readChannel, amplitudes, info)) {
         //        cout << "ERROR: Could not load sample: " <<myPath << endl; //This line seems to be hated by windows
         printf("ERROR: Could not load sample.");
-
+        return false;
     }
 
-
-    return result; // this should probably be something more descriptive
+    myChannels = (short) info.channels;
+    mySampleRate = info.sampleRate;
+    myBitsPerSample = (short) info.bitsPerSample;
+    myFormat = info.isFloat ? 3 : 1;
+    myBlockAlign = (short) (myChannels * myBitsPerSample / 8);
+    myByteRate = mySampleRate * myBlockAlign;
+    position = amplitudes.size();
+    cout << "Ch: " << myChannels << ", len: " << amplitudes.size() << endl;
+    return true;
 }
 
 // -----------------
@@ -735,25 +1412,29 @@ bool maxiSample::save(string filename)
 
     vector<short> shortAmps(amplitudes.size());
     for(int i=0; i < shortAmps.size(); i++) {
-        shortAmps[i] = static_cast<short>(round(amplitudes[i] * 32767.0));
+        shortAmps[i] = static_cast<short>(round(maxiMap::clamp<double>(amplitudes[i], -1.0, 1.0) * 32767.0));
     }
+    //the sample holds one channel whatever it was loaded from, so that's what is written, as 16 bit PCM
+    short format = 1, channels = 1, bitsPerSample = 16, blockAlign = 2;
+    int byteRate = mySampleRate * blockAlign;
+    int subChunk1Size = 16;
+    int myDataSize = shortAmps.size() * 2;
+    int chunkSize = 36 + myDataSize;
     // write the wav file per the wav file format
     myFile.seekp (0, ios::beg);
     myFile.write ("RIFF", 4);
-    myFile.write ((char*) &myChunkSize, 4);
+    myFile.write ((char*) &chunkSize, 4);
     myFile.write ("WAVE", 4);
     myFile.write ("fmt ", 4);
-    myFile.write ((char*) &mySubChunk1Size, 4);
-    myFile.write ((char*) &myFormat, 2);
-    myFile.write ((char*) &myChannels, 2);
+    myFile.write ((char*) &subChunk1Size, 4);
+    myFile.write ((char*) &format, 2);
+    myFile.write ((char*) &channels, 2);
     myFile.write ((char*) &mySampleRate, 4);
-    myFile.write ((char*) &myByteRate, 4);
-    myFile.write ((char*) &myBlockAlign, 2);
-    myFile.write ((char*) &myBitsPerSample, 2);
+    myFile.write ((char*) &byteRate, 4);
+    myFile.write ((char*) &blockAlign, 2);
+    myFile.write ((char*) &bitsPerSample, 2);
     myFile.write ("data", 4);
-    int myDataSize = shortAmps.size() * 2;
     myFile.write ((char*) &myDataSize, 4);
-    //        myFile.write ((char*) temp, myDataSize);
     myFile.write ((char*) shortAmps.data(), myDataSize);
     return true;
 }
@@ -783,7 +1464,7 @@ double maxiSample::play(double frequency, double start, double end, double &pos)
 		}
 
 		if ( pos >= end ) pos = start;
-		pos += ((end-start)/((maxiSettings::sampleRate)/(frequency*chandiv)));
+		pos += ((end-start) * frequency * chandiv * context->sampleDuration);
 		remainder = pos - floor(pos);
 		long posl = floor(pos);
 		if (posl+1<amplitudes.size()) {
@@ -805,7 +1486,7 @@ double maxiSample::play(double frequency, double start, double end, double &pos)
 	} else {
 		frequency*=-1.;
 		if ( pos <= start ) pos = end;
-		pos -= ((end-start)/(maxiSettings::sampleRate/(frequency*chandiv)));
+		pos -= ((end-start) * frequency * chandiv * context->sampleDuration);
 		remainder = pos - floor(pos);
 		long posl = floor(pos);
 		if (posl-1>=0) {
@@ -838,7 +1519,7 @@ double maxiSample::play4(double frequency, double start, double end) {
 			position=start;
 		}
 		if ( position >= end ) position = start;
-		position += ((end-start)/(maxiSettings::sampleRate/(frequency*chandiv)));
+		position += ((end-start) * frequency * chandiv * context->sampleDuration);
 		remainder = position - floor(position);
 		if (position>0) {
 			a=amplitudes[(int)(floor(position))-1];
@@ -870,7 +1551,7 @@ double maxiSample::play4(double frequency, double start, double end) {
 	} else {
 		frequency*=-1.;
 		if ( position <= start ) position = end;
-		position -= ((end-start)/(maxiSettings::sampleRate/(frequency*chandiv)));
+		position -= ((end-start) * frequency * chandiv * context->sampleDuration);
 		remainder = position - floor(position);
 		if (position>start && position < end-1) {
 			a=amplitudes[(long) position+1];
@@ -957,7 +1638,7 @@ double maxiSample::loopSetPosOnZX(double trig, double pos) {
 
 //Same as above but takes a speed value specified as a ratio, with 1.0 as original speed
 double maxiSample::playOnce(double speed) {
-	position=position+((speed*chandiv)/(maxiSettings::sampleRate/mySampleRate));
+	position=position+(speed * chandiv * mySampleRate * context->sampleDuration);
 	double remainder = position - (long) position;
 	if ((long) position<amplitudes.size())
 		output = ((1-remainder) * amplitudes[1+ (long) position] + remainder * amplitudes[2+(long) position]);//linear interpolation
@@ -970,7 +1651,7 @@ double maxiSample::playOnce(double speed) {
 double maxiSample::play(double speed) {
 	double remainder;
 	long a,b;
-	position=position+((speed*chandiv)/(maxiSettings::sampleRate/mySampleRate));
+	position=position+(speed * chandiv * mySampleRate * context->sampleDuration);
 	if (speed >=0) {
 
 		if ((long) position>=amplitudes.size()-1) position=1;
@@ -1025,8 +1706,9 @@ void maxiSample::normalise(double maxLevel) {
 		}
 	}
 	float scale = maxLevel / maxValue;
-	for(int i=0; i < amplitudes.size(); i++) {
-		amplitudes[i] = round(scale * amplitudes[i]);
+	vector<float> &samples = amplitudes.edit();
+	for(int i=0; i < samples.size(); i++) {
+		samples[i] = scale * samples[i];
 	}
 }
 
@@ -1060,20 +1742,20 @@ void maxiSample::autoTrim(float alpha, float threshold, bool trimStart, bool tri
 
     int newLength = endMarker - startMarker;
     if (newLength > 0) {
-        vector<double> newAmps(newLength);
+        vector<float> newAmps(newLength);
         for(int i=0; i < newLength; i++) {
             newAmps[i] = amplitudes[i+startMarker];
         }
-        amplitudes = newAmps;
         position=0;
         recordPosition=0;
         //envelope the start
-        int fadeSize=min((unsigned long)100, (unsigned long)amplitudes.size());
+        int fadeSize=min((unsigned long)100, (unsigned long)newAmps.size());
         for(int i=0; i < fadeSize; i++) {
             double factor = i / (double) fadeSize;
-            amplitudes[i] = round(amplitudes[i] * factor);
-            amplitudes[amplitudes.size() - 1 - i] = round(amplitudes[amplitudes.size() - 1 - i] * factor);
+            newAmps[i] = newAmps[i] * factor;
+            newAmps[newAmps.size() - 1 - i] = newAmps[newAmps.size() - 1 - i] * factor;
         }
+        amplitudes = std::move(newAmps);
     }
 }
 
@@ -1185,12 +1867,19 @@ double maxiDyn::compress(double input) {
 	return output*(1+log(ratio));
 }
 
-void maxiDyn::setAttack(double attackMS) {
-	attack = pow( 0.01, 1.0 / ( attackMS * maxiSettings::sampleRate * 0.001 ) );
+void maxiDyn::setAttack(double attackMSIn) {
+	attackMS = attackMSIn;
+	attack = pow( 0.01, 1.0 / ( attackMS * context->samplesPerMs ) );
+}
+
+void maxiDyn::setRelease(double releaseMSIn) {
+	releaseMS = releaseMSIn;
+	release = pow( 0.01, 1.0 / ( releaseMS * context->samplesPerMs ) );
 }
 
-void maxiDyn::setRelease(double releaseMS) {
-	release = pow( 0.01, 1.0 / ( releaseMS * maxiSettings::sampleRate * 0.001 ) );
+void maxiDyn::contextChanged() {
+	if (attackMS > 0) setAttack(attackMS);
+	if (releaseMS > 0) setRelease(releaseMS);
 }
 
 void maxiDyn::setThreshold(double thresholdI) {
@@ -1354,20 +2043,29 @@ double maxiEnv::adsr(double input, int trigger) {
 }
 
 
-void maxiEnv::setAttack(double attackMS) {
-	attack = 1-pow( 0.01, 1.0 / ( attackMS * maxiSettings::sampleRate * 0.001 ) );
+void maxiEnv::setAttack(double attackMSIn) {
+	attackMS = attackMSIn;
+	attack = 1-pow( 0.01, 1.0 / ( attackMS * context->samplesPerMs ) );
 }
 
-void maxiEnv::setRelease(double releaseMS) {
-	release = pow( 0.01, 1.0 / ( releaseMS * maxiSettings::sampleRate * 0.001 ) );
+void maxiEnv::setRelease(double releaseMSIn) {
+	releaseMS = releaseMSIn;
+	release = pow( 0.01, 1.0 / ( releaseMS * context->samplesPerMs ) );
 }
 
 void maxiEnv::setSustain(double sustainL) {
 	sustain = sustainL;
 }
 
-void maxiEnv::setDecay(double decayMS) {
-	decay = pow( 0.01, 1.0 / ( decayMS * maxiSettings::sampleRate * 0.001 ) );
+void maxiEnv::setDecay(double decayMSIn) {
+	decayMS = decayMSIn;
+	decay = pow( 0.01, 1.0 / ( decayMS * context->samplesPerMs ) );
+}
+
+void maxiEnv::contextChanged() {
+	if (attackMS > 0) setAttack(attackMS);
+	if (decayMS > 0) setDecay(decayMS);
+	if (releaseMS > 0) setRelease(releaseMS);
 }
 
 
@@ -1380,9 +2078,112 @@ double convert::mtof(int midinote) {
 
 
 template<> void maxiEnvelopeFollower::setAttack(double attackMS) {
-	attack = pow( 0.01, 1.0 / ( attackMS * maxiSettings::sampleRate * 0.001 ) );
+	attackTime = attackMS;
+	attack = pow( 0.01, 1.0 / ( attackMS * context->samplesPerMs ) );
 }
 
 template<> void maxiEnvelopeFollower::setRelease(double releaseMS) {
-	release = pow( 0.01, 1.0 / ( releaseMS * maxiSettings::sampleRate * 0.001 ) );
+	releaseTime = releaseMS;
+	release = pow( 0.01, 1.0 / ( releaseMS * context->samplesPerMs ) );
+}
+
+
+//sum over j of sin(phase j - phase i) is N times (mean sin * cos(phase i) - mean cos * sin(phase i)),
+//so each step needs the mean sine and cosine of the phases and nothing else from the other oscillators
+maxiKuramotoOscillatorSet::maxiKuramotoOscillatorSet(const size_t N) : phase(N, 0.f), offset(N, 0.f), sine(N, 0.f), cosine(N, 1.f) {
+}
+
+void maxiKuramotoOscillatorSet::setPhases(const std::vector<double> &phases) {
+	for (size_t i = 0; i < phases.size() && i < phase.size(); i++) {
+		setPhase(phases[i], i);
+	}
+}
+
+void maxiKuramotoOscillatorSet::setPhase(const double newPhase, const size_t oscillatorIdx) {
+	const double cycles = newPhase / TWOPI;
+	phase[oscillatorIdx] = (float) (cycles - floor(cycles));
+	meanFieldValid = false;
+}
+
+void maxiKuramotoOscillatorSet::setFrequencyOffset(const double newOffset, const size_t oscillatorIdx) {
+	offset[oscillatorIdx] = (float) newOffset;
+}
+
+void maxiKuramotoOscillatorSet::updateMeanField() {
+	float sumSine = 0, sumCosine = 0;
+	for (size_t i = 0; i < phase.size(); i++) {
+		sine[i] = maxiFastMath::sinCycle(phase[i]);
+		cosine[i] = maxiFastMath::sinCycle(phase[i] + 0.25f);
+		sumSine += sine[i];
+		sumCosine += cosine[i];
+	}
+	meanSine = phase.empty() ? 0.f : sumSine / phase.size();
+	meanCosine = phase.empty() ? 0.f : sumCosine / phase.size();
+	meanFieldValid = true;
+}
+
+double maxiKuramotoOscillatorSet::getCoherence() {
+	if (!meanFieldValid) updateMeanField();
+	return sqrt(meanSine * meanSine + meanCosine * meanCosine);
+}
+
+double maxiKuramotoOscillatorSet::getMeanPhase() {
+	if (!meanFieldValid) updateMeanField();
+	const double angle = atan2(meanSine, meanCosine);
+	return angle < 0 ? angle + TWOPI : angle;
+}
+
+float maxiKuramotoOscillatorSet::step(double freq, double K) {
+	if (!meanFieldValid) updateMeanField();
+	const size_t n = phase.size();
+	if (n == 0) return 0.f;
+
+	const float cyclesPerHz = (float) context->sampleDuration;
+	const float base = (float) freq * cyclesPerHz;
+	const float pullSine = (float) (K * meanSine) * cyclesPerHz;
+	const float pullCosine = (float) (K * meanCosine) * cyclesPerHz;
+
+	//one pass moves every phase on and gathers the mean field for the next step, in 8 running sums
+	//so the adds vectorise too
+	const int laneWidth = 8;
+	float sumSine[laneWidth] = {}, sumCosine[laneWidth] = {}, sumPhase[laneWidth] = {};
+	float *p = phase.data(), *s = sine.data(), *c = cosine.data();
+	const float *f = offset.data();
+
+	auto advance = [&](size_t i, int lane) {
+		float x = p[i] + base + f[i] * cyclesPerHz + pullSine * c[i] - pullCosine * s[i];
+		x -= (float) (int) x;
+		x += x < 0.f ? 1.f : 0.f;
+		p[i] = x;
+		s[i] = maxiFastMath::sinCycle(x);
+		c[i] = maxiFastMath::sinCycle(x + 0.25f);
+		sumSine[lane] += s[i];
+		sumCosine[lane] += c[i];
+		sumPhase[lane] += x;
+	};
+
+	size_t i = 0;
+	for (; i + laneWidth <= n; i += laneWidth) {
+		for (int lane = 0; lane < laneWidth; lane++) advance(i + lane, lane);
+	}
+	for (; i < n; i++) advance(i, 0);
+
+	for (int lane = 1; lane < laneWidth; lane++) {
+		sumSine[0] += sumSine[lane];
+		sumCosine[0] += sumCosine[lane];
+		sumPhase[0] += sumPhase[lane];
+	}
+	meanSine = sumSine[0] / n;
+	meanCosine = sumCosine[0] / n;
+	return sumPhase[0] / n * (float) TWOPI;
+}
+
+double maxiKuramotoOscillatorSet::play(double freq, double K) {
+	return step(freq, K);
+}
+
+void maxiKuramotoOscillatorSet::play(float *output, int numSamples, double freq, double K) {
+	for (int i = 0; i < numSamples; i++) {
+		output[i] = step(freq, K);
+	}
 }
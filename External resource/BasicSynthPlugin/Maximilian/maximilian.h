@@ -54,9 +54,12 @@ gate oscillator - gateOsc.play([1,0,0,0,0,1,0,0], 400ms)
 #include <cmath>
 #include <vector>
 #include <cfloat>
-#ifdef _WIN32 //|| _WIN64
+#include <limits>
+#include <cstdint>
 #include <algorithm>
-#endif
+#include "maxiTables.h"
+#include "maxiContext.h"
+#include "maxiSamplePool.h"
 
 using namespace std;
 #ifndef PI
@@ -65,9 +68,10 @@ using namespace std;
 #define TWOPI 6.283185307179586476925286766559
 
 
-const double pitchRatios[256]= {0.0006517771980725,0.0006905338959768,0.0007315951515920, 0.0007750981021672, 0.0008211878011934, 0.0008700182079338, 0.0009217521874234, 0.0009765623835847, 0.0010346318595111, 0.0010961542138830, 0.0011613349197432, 0.0012303915573284, 0.0013035543961450, 0.0013810677919537, 0.0014631903031841, 0.0015501962043345, 0.0016423756023869, 0.0017400364158675, 0.0018435043748468, 0.0019531247671694, 0.0020692637190223, 0.0021923084277660, 0.0023226698394865, 0.0024607831146568, 0.0026071087922901, 0.0027621355839074, 0.0029263808391988, 0.0031003924086690, 0.0032847514376044, 0.0034800728317350, 0.0036870087496936, 0.0039062497671694, 0.0041385274380445, 0.0043846168555319, 0.0046453396789730, 0.0049215662293136, 0.0052142175845802, 0.0055242711678147, 0.0058527616783977, 0.0062007848173380, 0.0065695028752089, 0.0069601456634700, 0.0073740174993873, 0.0078124995343387, 0.0082770548760891, 0.0087692337110639, 0.0092906802892685, 0.0098431324586272, 0.0104284351691604, 0.0110485423356295, 0.0117055233567953, 0.0124015696346760, 0.0131390057504177, 0.0139202913269401, 0.0147480349987745, 0.0156249990686774, 0.0165541097521782, 0.0175384692847729, 0.0185813605785370, 0.0196862649172544, 0.0208568722009659, 0.0220970865339041, 0.0234110467135906, 0.0248031392693520, 0.0262780115008354, 0.0278405826538801, 0.0294960699975491, 0.0312499981373549, 0.0331082195043564, 0.0350769385695457, 0.0371627211570740, 0.0393725298345089, 0.0417137444019318, 0.0441941730678082, 0.0468220934271812, 0.0496062822639942, 0.0525560230016708, 0.0556811690330505, 0.0589921437203884, 0.0624999962747097, 0.0662164390087128, 0.0701538771390915, 0.0743254423141479, 0.0787450596690178, 0.0834274888038635, 0.0883883461356163, 0.0936441868543625, 0.0992125645279884, 0.1051120460033417, 0.1113623380661011, 0.1179842874407768, 0.1249999925494194, 0.1324328780174255, 0.1403077542781830, 0.1486508846282959, 0.1574901193380356, 0.1668549776077271, 0.1767766922712326, 0.1872883737087250, 0.1984251290559769, 0.2102240920066833, 0.2227246761322021, 0.2359685748815536, 0.2500000000000000, 0.2648657560348511, 0.2806155085563660, 0.2973017692565918, 0.3149802684783936, 0.3337099552154541, 0.3535533845424652, 0.3745767772197723, 0.3968502581119537, 0.4204482138156891, 0.4454493522644043, 0.4719371497631073, 0.5000000000000000, 0.5297315716743469, 0.5612310171127319, 0.5946035385131836, 0.6299605369567871, 0.6674199104309082, 0.7071067690849304, 0.7491535544395447, 0.7937005162239075, 0.8408964276313782, 0.8908987045288086, 0.9438742995262146, 1.0000000000000000, 1.0594631433486938, 1.1224620342254639, 1.1892070770263672, 1.2599210739135742, 1.3348398208618164, 1.4142135381698608, 1.4983071088790894, 1.5874010324478149, 1.6817928552627563, 1.7817974090576172, 1.8877485990524292, 2.0000000000000000, 2.1189262866973877, 2.2449240684509277, 2.3784141540527344, 2.5198421478271484, 2.6696796417236328, 2.8284270763397217, 2.9966142177581787, 3.1748020648956299, 3.3635857105255127, 3.5635950565338135, 3.7754974365234375, 4.0000000000000000, 4.2378525733947754, 4.4898481369018555, 4.7568287849426270, 5.0396842956542969, 5.3393597602844238, 5.6568546295166016, 5.9932284355163574, 6.3496046066284180, 6.7271714210510254, 7.1271901130676270, 7.5509948730468750, 8.0000000000000000, 8.4757051467895508, 8.9796962738037109, 9.5136575698852539, 10.0793685913085938, 10.6787195205688477, 11.3137092590332031, 11.9864568710327148, 12.6992092132568359, 13.4543428421020508, 14.2543802261352539, 15.1019897460937500, 16.0000000000000000, 16.9514102935791016, 17.9593944549560547, 19.0273151397705078, 20.1587371826171875, 21.3574390411376953, 22.6274185180664062, 23.9729137420654297, 25.3984184265136719, 26.9086875915527344, 28.5087604522705078, 30.2039794921875000, 32.0000000000000000, 33.9028205871582031, 35.9187889099121094, 38.0546302795410156, 40.3174743652343750, 42.7148780822753906, 45.2548370361328125, 47.9458274841308594, 50.7968368530273438, 53.8173751831054688, 57.0175209045410156, 60.4079589843750000, 64.0000076293945312, 67.8056411743164062, 71.8375778198242188, 76.1092605590820312, 80.6349563598632812, 85.4297561645507812, 90.5096740722656250, 95.8916625976562500, 101.5936737060546875, 107.6347503662109375, 114.0350418090820312, 120.8159179687500000, 128.0000152587890625, 135.6112823486328125, 143.6751556396484375, 152.2185211181640625, 161.2699127197265625, 170.8595123291015625, 181.0193481445312500, 191.7833251953125000, 203.1873474121093750, 215.2695007324218750, 228.0700836181640625, 241.6318511962890625, 256.0000305175781250, 271.2225646972656250, 287.3503112792968750, 304.4370422363281250, 322.5398254394531250, 341.7190246582031250, 362.0386962890625000, 383.5666503906250000, 406.3746948242187500, 430.5390014648437500, 456.1401977539062500, 483.2637023925781250, 512.0000610351562500, 542.4451293945312500, 574.7006225585937500, 608.8740844726562500, 645.0796508789062500, 683.4380493164062500, 724.0773925781250000, 767.1333007812500000, 812.7494506835937500, 861.0780029296875000, 912.2803955078125000, 966.5274047851562500, 1024.0001220703125000, 1084.8903808593750000, 1149.4012451171875000, 1217.7481689453125000, 1290.1593017578125000, 1366.8762207031250000, 1448.1549072265625000, 1534.2666015625000000, 1625.4989013671875000};
+static constexpr maxiTable<double, 256, maxiPitchRatioShape> pitchRatios {};
 
 
+//The settings of the default context. Ugens given a context of their own don't use these.
 class maxiSettings {
 public:
 	static int sampleRate;
@@ -77,18 +81,22 @@ public:
 		maxiSettings::sampleRate = initSampleRate;
 		maxiSettings::channels = initChannels;
 		maxiSettings::bufferSize = initBufferSize;
+		maxiContext::getDefault().setup(sampleRate, channels, bufferSize);
 	}
 
 	void setSampleRate(int sampleRate_){
 		sampleRate = sampleRate_;
+		maxiContext::getDefault().setup(sampleRate, channels, bufferSize);
 	}
 
 	void setNumChannels(int channels_){
 		channels = channels_;
+		maxiContext::getDefault().setup(sampleRate, channels, bufferSize);
 	}
 
 	void setBufferSize(int bufferSize_){
 		bufferSize = bufferSize_;
+		maxiContext::getDefault().setup(sampleRate, channels, bufferSize);
 	}
 
 	int getSampleRate() const{
@@ -107,7 +115,80 @@ public:
 
 
 
-class maxiOsc {
+class maxiFastMath {
+public:
+	//sin(2*PI*x) with x measured in cycles. The phase is folded into a quarter cycle and fed to an
+	//11th order polynomial, so there are no calls or branches and loops using it can be vectorised.
+	//Max error is around 5e-7.
+	static inline float sinCycle(float x) {
+		x -= (float) (int) (x + std::copysign(0.5f, x));     // -0.5 .. 0.5
+		const float ax = std::fabs(x);
+		const float r = std::copysign(std::min(ax, 0.5f - ax), x) * (float) TWOPI; // same sine, +-0.25 cycle
+		const float r2 = r * r;
+		return r * (1.f + r2 * (-1.6666667e-1f + r2 * (8.3333333e-3f + r2 * (-1.9841270e-4f
+				+ r2 * (2.7557319e-6f + r2 * -2.5052108e-8f)))));
+	}
+};
+
+
+/*
+ Fast random numbers (xoshiro128+), one generator per object, so voices and threads never share
+ state and each can be seeded to give the same noise on every run. Without a seed every generator
+ gets a different one from a process-wide count, so two noise sources built in the same order
+ always sound the same but never sound like each other. Not for anything that needs to be secure.
+ */
+class maxiRandom {
+public:
+	maxiRandom() { setSeed(nextDefaultSeed()); }
+	maxiRandom(uint64_t seed) { setSeed(seed); }
+
+	void setSeed(uint64_t seed);
+
+	//32 random bits
+	inline uint32_t next() {
+		const uint32_t result = state[0] + state[3];
+		const uint32_t t = state[1] << 9;
+		state[2] ^= state[0];
+		state[3] ^= state[1];
+		state[1] ^= state[2];
+		state[0] ^= state[3];
+		state[2] ^= t;
+		state[3] = (state[3] << 11) | (state[3] >> 21);
+		return result;
+	}
+
+	//0 to below 1, from the top 24 bits which are the best ones
+	inline float uniform() { return (next() >> 8) * (1.f / 16777216.f); }
+
+	//-1 to below 1
+	inline float bipolar() { return uniform() * 2.f - 1.f; }
+
+	//0 to below range, range up to 65536
+	inline int below(int range) { return (int) (((next() >> 16) * (uint32_t) range) >> 16); }
+
+	//normal distribution, mean 0 and standard deviation 1
+	float gaussian();
+
+	//pink noise, about -1 to 1
+	float pink();
+
+	//block versions
+	void uniform(float *output, int numSamples);
+	void bipolar(float *output, int numSamples);
+	void gaussian(float *output, int numSamples);
+	void pink(float *output, int numSamples);
+
+private:
+	static uint64_t nextDefaultSeed();
+
+	uint32_t state[4];
+	float pinkState[7];
+	float spareGaussian;
+	bool haveSpareGaussian;
+};
+
+
+class maxiOsc : public maxiContextUser {
 
 	double frequency;
 	double phase;
@@ -115,6 +196,7 @@ class maxiOsc {
 	double endphase;
 	double output;
 	double tri;
+	maxiRandom random;
 
 
 public:
@@ -134,12 +216,221 @@ public:
     double sawn(double frequency);
     double rect(double frequency, double duty=0.5);
 
+	//block version of sinewave(). Writes numSamples into output and leaves the phase exactly where
+	//numSamples calls to sinewave(frequency) would, output matches the per-sample version to within 1e-6.
+	void sinewave(float *output, int numSamples, double frequency);
+
+	//block versions of the other waveforms. The first form of each runs at a fixed frequency and leaves the
+	//phase exactly where numSamples per-sample calls would, so block and per-sample calls can be mixed on
+	//one oscillator. The second takes one frequency in Hz per sample and multiplies it by a precomputed
+	//1/sampleRate, so its phase can differ from the per-sample calls in the last bits and a wrap can land
+	//one sample away. The phase is walked in double precision, then the waveform is computed over the
+	//whole block in float. Against the per-sample versions: sinewave, coswave, sinebuf and sinebuf4 are
+	//within 1e-6, phasor, saw and triangle within 3e-7, sawn within 1e-5, and square, pulse and impulse
+	//are exact below Nyquist. sinebuf4 reads in front of its table for the first point of each cycle,
+	//the block version wraps round to the end of the table instead.
+	void sinewave(float *output, const float *frequency, int numSamples);
+	void coswave(float *output, int numSamples, double frequency);
+	void coswave(float *output, const float *frequency, int numSamples);
+	void phasor(float *output, int numSamples, double frequency);
+	void phasor(float *output, const float *frequency, int numSamples);
+	void phasor(float *output, int numSamples, double frequency, double startphase, double endphase);
+	void saw(float *output, int numSamples, double frequency);
+	void saw(float *output, const float *frequency, int numSamples);
+	void triangle(float *output, int numSamples, double frequency);
+	void triangle(float *output, const float *frequency, int numSamples);
+	void square(float *output, int numSamples, double frequency);
+	void square(float *output, const float *frequency, int numSamples);
+	void pulse(float *output, int numSamples, double frequency, double duty);
+	void pulse(float *output, const float *frequency, int numSamples, double duty);
+	void impulse(float *output, int numSamples, double frequency);
+	void impulse(float *output, const float *frequency, int numSamples);
+	void sinebuf(float *output, int numSamples, double frequency);
+	void sinebuf(float *output, const float *frequency, int numSamples);
+	void sinebuf4(float *output, int numSamples, double frequency);
+	void sinebuf4(float *output, const float *frequency, int numSamples);
+	void sawn(float *output, int numSamples, double frequency);
+	void sawn(float *output, const float *frequency, int numSamples);
+	void noise(float *output, int numSamples);
+
+	//noise() comes from a generator of its own, seed it to get the same noise every run
+	void setNoiseSeed(uint64_t seed) { random.setSeed(seed); }
+
 	void phaseReset(double phaseIn);
 
 };
 
+/*
+ Band-limited oscillator
+
+ PolyBLEP correction of the sawtooth, square and pulse steps and PolyBLAMP correction of the
+ triangle corners. Each discontinuity gets a two sample polynomial residual subtracted, which
+ removes most of the aliasing that maxiOsc::saw, square and pulse produce without having to run
+ at a higher sample rate. Use it in place of sawn(), which also needs a table lookup per sample.
+ usage:
+
+ maxiBLOsc osc;
+ osc.setWaveform(maxiBLOsc::PULSE);
+ osc.setPulseWidth(0.25);
+
+ w = osc.play(220);
+
+ or for a block
+
+ osc.play(buffer, numSamples, 220);
+
+ */
+class maxiBLOsc : public maxiContextUser {
+public:
+	enum waveTypes {SAW, SQUARE, PULSE, TRIANGLE};
+
+	maxiBLOsc();
+
+	inline void setWaveform(waveTypes newWaveform) {
+		waveform = newWaveform;
+	}
+
+	//fraction of the cycle spent high in PULSE mode, kept two samples clear of either end by play()
+	inline void setPulseWidth(double width) {
+		pulseWidth = width;
+	}
 
-class maxiEnvelope {
+	double play(double frequency);
+
+	//block versions with the same conventions as the maxiOsc ones: a fixed frequency, or one
+	//frequency in Hz per sample. Within 1e-6 of play() except on the samples next to an edge, where
+	//the float phase error is scaled up by 1/increment, which is within 1e-4 at 100Hz.
+	void play(float *output, int numSamples, double frequency);
+	void play(float *output, const float *frequency, int numSamples);
+
+	void phaseReset(double phaseIn);
+
+private:
+	double phase;
+	double pulseWidth;
+	waveTypes waveform;
+};
+
+/*
+ Oscillator core with a 32 bit unsigned phase accumulator. The full range of the accumulator is one
+ cycle, so wrapping is just integer overflow, and the phase never drifts however long a note is held:
+ the same increment always comes back to exactly the same phase. Table index and interpolation
+ fraction are the top bits and the bits below them, so there are no floors or branches per sample,
+ and the block versions vectorise as a single loop. Waveforms match the maxiOsc ones of the same name.
+ */
+class maxiFixedPointOsc : public maxiContextUser {
+public:
+	maxiFixedPointOsc();
+
+	//phase step per sample for a frequency, in 1/2^32 of a cycle. Negative frequencies wrap round.
+	static uint32_t phaseIncrement(double frequency, double sampleRate = maxiContext::getDefault().sampleRate) {
+		return (uint32_t) (int64_t) floor(frequency / sampleRate * 4294967296.0 + 0.5);
+	}
+
+	double sinewave(double frequency);
+	double phasor(double frequency);
+	double saw(double frequency);
+	double triangle(double frequency);
+	double square(double frequency);
+	double pulse(double frequency, double duty);
+	double sinebuf(double frequency);
+	double sinebuf4(double frequency);
+
+	//block versions, a fixed frequency or one frequency in Hz per sample (below Nyquist)
+	void sinewave(float *output, int numSamples, double frequency);
+	void sinewave(float *output, const float *frequency, int numSamples);
+	void phasor(float *output, int numSamples, double frequency);
+	void phasor(float *output, const float *frequency, int numSamples);
+	void saw(float *output, int numSamples, double frequency);
+	void saw(float *output, const float *frequency, int numSamples);
+	void triangle(float *output, int numSamples, double frequency);
+	void triangle(float *output, const float *frequency, int numSamples);
+	void square(float *output, int numSamples, double frequency);
+	void square(float *output, const float *frequency, int numSamples);
+	void pulse(float *output, int numSamples, double frequency, double duty);
+	void pulse(float *output, const float *frequency, int numSamples, double duty);
+	void sinebuf(float *output, int numSamples, double frequency);
+	void sinebuf(float *output, const float *frequency, int numSamples);
+	void sinebuf4(float *output, int numSamples, double frequency);
+	void sinebuf4(float *output, const float *frequency, int numSamples);
+
+	void phaseReset(double phaseIn);
+	uint32_t getPhase() const { return phase; }
+
+private:
+	template <class Wave> void fill(float *output, int numSamples, double frequency, Wave wave);
+	template <class Wave> void fill(float *output, const float *frequency, int numSamples, Wave wave);
+
+	//phaseIncrement for the context's rate, worked out again only when the frequency or rate changes
+	uint32_t increment(double frequency) {
+		if (frequency != lastFrequency || context->sampleDuration != lastSampleDuration) {
+			lastFrequency = frequency;
+			lastSampleDuration = context->sampleDuration;
+			lastIncrement = (uint32_t) (int64_t) floor(frequency * lastSampleDuration * 4294967296.0 + 0.5);
+		}
+		return lastIncrement;
+	}
+
+	uint32_t phase;
+	uint32_t lastIncrement;
+	double lastFrequency, lastSampleDuration;
+};
+
+/*
+ Unison oscillator, up to 16 detuned copies of one band-limited waveform (see maxiBLOsc) spread
+ across the stereo field, the supersaw when the waveform is SAW. Each copy runs on a fixed point
+ phase accumulator (see maxiFixedPointOsc) and is rendered a block at a time with the samples in
+ SIMD lanes, then mixed straight into the two output channels. The mix is scaled by 1/sqrt(voices)
+ so the level stays about the same as voices are added.
+ usage:
+
+ maxiUnison unison;
+ unison.setNumVoices(7);
+ unison.setDetune(25);   //cents either side
+ unison.retrigger();     //at note on, randomises the phases
+
+ unison.play(left, right, numSamples, 110);
+
+ */
+class maxiUnison : public maxiContextUser {
+public:
+	static const int maxVoices = 16;
+	enum waveTypes {SAW, SQUARE, TRIANGLE, SINE};
+
+	maxiUnison();
+
+	void setWaveform(waveTypes newWaveform) { waveform = newWaveform; }
+	void setNumVoices(int newNumVoices);
+
+	//pitch of the outermost copies in cents above and below the played frequency, the rest are evenly spaced between
+	void setDetune(double cents);
+
+	//0 puts every copy in the centre, 1 spreads them from hard left to hard right
+	void setSpread(double width);
+
+	//0 starts every copy at the same phase on retrigger(), 1 starts each one anywhere in its cycle
+	void setPhaseRandomness(double amount) { randomness = std::min(std::max(amount, 0.0), 1.0); }
+
+	void setSeed(uint64_t seed) { random.setSeed(seed); }
+	void retrigger();
+
+	//writes numSamples into both channels, frequency below Nyquist
+	void play(float *left, float *right, int numSamples, double frequency);
+
+private:
+	void update();
+
+	waveTypes waveform;
+	int numVoices;
+	double detune, spread, randomness;
+	uint32_t phase[maxVoices];
+	double ratio[maxVoices];
+	float gainLeft[maxVoices], gainRight[maxVoices];
+	maxiRandom random;
+};
+
+
+class maxiEnvelope : public maxiContextUser {
 
 	double period;
 	double output;
@@ -194,7 +485,57 @@ public:
 };
 
 
-class maxiFilter {
+/*
+ The coefficients of a filter, worked out again only when the parameters they come from change.
+ Per sample processing uses them as they are. Block processing glides to them from wherever the
+ last block finished, a step per sample, so a parameter moved once per block is smoothed rather
+ than stepped.
+ usage:
+
+ if (coefficients.update(cutoff, resonance)) {
+	 ...work out coefficients.value...
+ }
+ double from[size], step[size];
+ coefficients.glide(from, step, numSamples);   //sample i uses from + step * (i + 1)
+
+ */
+template <int size>
+class maxiFilterCoefficients {
+public:
+	//true, and remembered, if the parameters differ from the ones the coefficients were made from
+	bool update(double first, double second, double third = 0, double fourth = 0) {
+		if (valid && first == parameters[0] && second == parameters[1] && third == parameters[2] && fourth == parameters[3]) return false;
+		parameters[0] = first;
+		parameters[1] = second;
+		parameters[2] = third;
+		parameters[3] = fourth;
+		valid = true;
+		return true;
+	}
+
+	//the first glide starts where it ends
+	void glide(double *from, double *step, int numSamples) {
+		if (!started) {
+			std::copy(value, value + size, start);
+			started = true;
+		}
+		for (int i = 0; i < size; i++) {
+			from[i] = start[i];
+			step[i] = numSamples > 0 ? (value[i] - start[i]) / numSamples : 0.0;
+			start[i] = value[i];
+		}
+	}
+
+	double value[size] = {};
+
+private:
+	double start[size] = {};
+	double parameters[4] = {};
+	bool valid = false, started = false;
+};
+
+
+class maxiFilter : public maxiContextUser {
 	double gain;
 	double input;
 	double output;
@@ -203,16 +544,27 @@ class maxiFilter {
 	double cutoff1;
 	double x;//speed
 	double y;//pos
-	double z;//pole
-	double c;//filter coefficient
+	maxiFilterCoefficients<2> resonant;     //lores and hires: filter coefficient and feedback
+	maxiFilterCoefficients<3> band;
+
+	void resonantCoefficients(double resonance);
+	void bandCoefficients(double resonance);
 
 public:
-	maxiFilter():x(0.0), y(0.0), z(0.0), c(0.0){};
+	maxiFilter():x(0.0), y(0.0){
+		std::fill(outputs, outputs + 10, 0.0);
+	};
 	double cutoff;
 	double resonance;
 	double lores(double input, double cutoff1, double resonance);
 	double hires(double input, double cutoff1, double resonance);
 	double bandpass(double input, double cutoff1, double resonance);
+
+	//block versions, the coefficients glide across the block from the last block's settings.
+	//output and input can be the same buffer.
+	void lores(float *output, const float *input, int numSamples, double cutoff1, double resonance);
+	void hires(float *output, const float *input, int numSamples, double cutoff1, double resonance);
+	void bandpass(float *output, const float *input, int numSamples, double cutoff1, double resonance);
 	double lopass(double input, double cutoff);
 	double hipass(double input, double cutoff);
 
@@ -314,12 +666,10 @@ public:
 };
 
 
-class maxiSample  {
+class maxiSample : public maxiContextUser {
 
 private:
 	string 	myPath;
-	int 	myChunkSize;
-	int	mySubChunk1Size;
 	int		readChannel;
 	short 	myFormat;
 	int   	myByteRate;
@@ -328,20 +678,25 @@ private:
 	double speed;
 	double output;
 	maxiLagExp<double> loopRecordLag;
+	bool recordMissed;
 
 public:
 //    int    myDataSize;
 	short 	myChannels;
 	int   	mySampleRate;
     inline unsigned long getLength() const {return amplitudes.size();};
+    //Cuts the end off or pads with silence. Leaves the sample with its own copy, ready to record
+    //into with loopRecord. Allocates, so not from the audio thread.
     void setLength(unsigned long numSamples);
     short 	myBitsPerSample;
 
-	vector<double> amplitudes;
+	//one channel, -1 to 1. Shared with every other sample loaded from the same file, or copied from
+	//this one, until one of them writes to it.
+	maxiSampleBuffer amplitudes;
 
 	~maxiSample() {}
 
-    maxiSample():position(0), recordPosition(0), myChannels(1), mySampleRate(maxiSettings::sampleRate) {};
+    maxiSample():position(0), recordPosition(0), recordMissed(false), myChannels(1), mySampleRate((int) context->sampleRate) {};
 
     maxiSample& operator=(const maxiSample &source) {
         if (this == &source)
@@ -349,8 +704,7 @@ public:
         position=0;
         recordPosition = 0;
         myChannels = source.myChannels;
-        mySampleRate = maxiSettings::sampleRate;
-		amplitudes.clear();
+        mySampleRate = source.mySampleRate;
 		amplitudes = source.amplitudes;
         return *this;
     }
@@ -376,14 +730,26 @@ public:
 	// read a wav file into this class
     bool read();
 
+    //Gives this sample its own copy of the samples to record into, if it shares them. Allocates,
+    //so call it before playback. A loaded sample shares its file's samples, and loopRecord can't
+    //record into it until this or setLength has been called.
+    void prepareForRecording() { amplitudes.edit(); }
+    bool canRecord() const { return !amplitudes.empty() && !amplitudes.isShared(); }
+
     void loopRecord(double newSample, const bool recordEnabled, const double recordMix, double start = 0.0, double end = 1.0) {
         loopRecordLag.addSample(recordEnabled);
         if (recordPosition < start * amplitudes.size()) recordPosition = start * amplitudes.size();
-        if(recordEnabled) {
-            double currentSample = amplitudes[(unsigned long)recordPosition] / 32767.0;
+        float *samples = amplitudes.getWritePointer();
+        if (recordEnabled && samples == nullptr && !recordMissed) {
+            //copying here would allocate on the audio thread, so say so once instead
+            cerr << "maxiSample::loopRecord: the samples are shared, call prepareForRecording() first" << endl;
+            recordMissed = true;
+        }
+        if(recordEnabled && samples != nullptr) {
+            double currentSample = samples[(unsigned long)recordPosition];
             newSample = (recordMix * currentSample) + ((1.0 - recordMix) * newSample);
             newSample *= loopRecordLag.value();
-            amplitudes[(unsigned long)recordPosition] = newSample * 32767;
+            samples[(unsigned long)recordPosition] = newSample;
         }
         ++recordPosition;
         if (recordPosition >= end * amplitudes.size())
@@ -423,7 +789,13 @@ public:
     char *getSummary();
 
     void normalise(double maxLevel = 0.99);  //0 < maxLevel < 1.0
-    void autoTrim(float alpha = 0.3, float threshold = 6000, bool trimStart = true, bool trimEnd = true); //alpha of lag filter (lower == slower reaction), threshold to mark start and end, < 32767
+    void autoTrim(float alpha = 0.3, float threshold = 0.18, bool trimStart = true, bool trimEnd = true); //alpha of lag filter (lower == slower reaction), threshold to mark start and end, < 1
+
+protected:
+    //a sample with nothing loaded plays at the rate it's bound to
+    void contextChanged() override {
+        if (amplitudes.empty()) mySampleRate = (int) context->sampleRate;
+    }
 };
 
 
@@ -460,7 +832,7 @@ public:
 };
 
 
-class maxiDyn {
+class maxiDyn : public maxiContextUser {
 
 
 public:
@@ -498,9 +870,16 @@ public:
 //	}
 
 	// ------------------------------------------------
+
+protected:
+	void contextChanged() override;
+
+private:
+	//the times last set, so the coefficients can follow the rate. 0 if never set.
+	double attackMS = 0, releaseMS = 0;
 };
 
-class maxiEnv {
+class maxiEnv : public maxiContextUser {
 
 
 public:
@@ -537,13 +916,20 @@ public:
 	}
 
 	// ------------------------------------------------
+
+protected:
+	void contextChanged() override;
+
+private:
+	//the times last set, so the coefficients can follow the rate. 0 if never set.
+	double attackMS = 0, decayMS = 0, releaseMS = 0;
 };
 
 class convert {
 public:
 	static double mtof(int midinote);
-    static double msToSamps(double timeMs) {
-        return timeMs / 1000.0 * maxiSettings::sampleRate;
+    static double msToSamps(double timeMs, const maxiContext &context = maxiContext::getDefault()) {
+        return timeMs * context.samplesPerMs;
     }
 };
 
@@ -659,7 +1045,7 @@ inline double maxiChorus::chorus(const double input, const unsigned int delay, c
 }
 
 template<typename T>
-class maxiEnvelopeFollowerType {
+class maxiEnvelopeFollowerType : public maxiContextUser {
 public:
     maxiEnvelopeFollowerType() {
         setAttack(100);
@@ -667,10 +1053,12 @@ public:
         env = 0;
     }
     void setAttack(T attackMS) {
-        attack = pow( 0.01, 1.0 / (attackMS * maxiSettings::sampleRate * 0.001 ) );
+        attackTime = attackMS;
+        attack = pow( 0.01, 1.0 / (attackMS * context->samplesPerMs ) );
     }
     void setRelease(T releaseMS) {
-        release = pow( 0.01, 1.0 / (releaseMS * maxiSettings::sampleRate * 0.001 ) );
+        releaseTime = releaseMS;
+        release = pow( 0.01, 1.0 / (releaseMS * context->samplesPerMs ) );
     }
     inline T play(T input) {
         input = fabs(input);
@@ -683,8 +1071,14 @@ public:
     void reset() {env=0;}
     inline T getEnv(){return env;}
     inline void setEnv(T val){env = val;}
+protected:
+    void contextChanged() override {
+        setAttack(attackTime);
+        setRelease(releaseTime);
+    }
 private:
     T attack, release, env;
+    T attackTime, releaseTime;
 };
 
 typedef maxiEnvelopeFollowerType<double> maxiEnvelopeFollower;
@@ -718,7 +1112,7 @@ public:
  w = filter.setCutoff(param1).setResonance(param2).play(w, 0.0, 1.0, 0.0, 0.0);
 
  */
-class maxiSVF {
+class maxiSVF : public maxiContextUser {
 public:
     maxiSVF() : v0z(0), v1(0), v2(0) { setParams(1000, 1);}
 
@@ -734,54 +1128,77 @@ public:
 
     //run the filter, and get a mixture of lowpass, bandpass, highpass and notch outputs
     inline double play(double w, double lpmix, double bpmix, double hpmix, double notchmix) {
+        const double *g = coefficients.value;
         double low, band, high, notch;
         double v1z = v1;
         double v2z = v2;
         double v3 = w + v0z - 2.0 * v2z;
-        v1 += g1*v3-g2*v1z;
-        v2 += g3*v3+g4*v1z;
+        v1 += g[0]*v3-g[1]*v1z;
+        v2 += g[2]*v3+g[3]*v1z;
         v0z = w;
         low = v2;
         band = v1;
-        high = w-k*v1-v2;
-        notch = w-k*v1;
+        high = w-g[4]*v1-v2;
+        notch = w-g[4]*v1;
         return (low * lpmix) + (band * bpmix) + (high * hpmix) + (notch * notchmix);
     }
 
+    //block version, the coefficients glide across the block from where the last block left them.
+    //output and input can be the same buffer.
+    void play(float *output, const float *input, int numSamples, double lpmix, double bpmix, double hpmix, double notchmix);
+
+protected:
+    void contextChanged() override { setParams(freq, res); }
+
 private:
     inline void setParams(double _freq, double _res) {
         freq = _freq;
         res = _res;
-        g = tan(PI * freq / maxiSettings::sampleRate);
-        damping = res == 0 ? 0 : 1.0 / res;
-        k = damping;
-        ginv = g / (1.0 + g * (g + k));
-        g1 = ginv;
-        g2 = 2.0 * (g + k) * ginv;
-        g3 = g * ginv;
-        g4 = 2.0 * ginv;
-    }
-
-    double v0z, v1, v2, g, damping, k, ginv, g1, g2, g3 ,g4;
+        if (!coefficients.update(freq * context->sampleDuration, res)) return;
+        const double g = tan(PI * freq * context->sampleDuration);
+        const double k = res == 0 ? 0 : 1.0 / res;
+        const double ginv = g / (1.0 + g * (g + k));
+        coefficients.value[0] = ginv;
+        coefficients.value[1] = 2.0 * (g + k) * ginv;
+        coefficients.value[2] = g * ginv;
+        coefficients.value[3] = 2.0 * ginv;
+        coefficients.value[4] = k;  //damping
+    }
+
+    double v0z, v1, v2;
+    maxiFilterCoefficients<5> coefficients;
     double freq, res;
 
 };
 
 //based on http://www.earlevel.com/main/2011/01/02/biquad-formulas/ and https://ccrma.stanford.edu/~jos/fp/Direct_Form_II.html
-class maxiBiquad {
+class maxiBiquad : public maxiContextUser {
 public:
     enum filterTypes {LOWPASS, HIGHPASS, BANDPASS, NOTCH, PEAK, LOWSHELF, HIGHSHELF};
     inline double play(double input) {
-        v[0] = input - (b1 * v[1]) - (b2 * v[2]);
-        double y = (a0 * v[0]) + (a1 * v[1]) + (a2 * v[2]);
+        const double *c = coefficients.value;   //a0, a1, a2, b1, b2
+        v[0] = input - (c[3] * v[1]) - (c[4] * v[2]);
+        double y = (c[0] * v[0]) + (c[1] * v[1]) + (c[2] * v[2]);
         v[2] = v[1];
         v[1] = v[0];
         return y;
     }
+    //block version, the coefficients glide across the block from where the last block left them.
+    //output and input can be the same buffer.
+    void play(float *output, const float *input, int numSamples);
+
+    //only works the coefficients out again if something has changed
     inline void set(filterTypes filtType, double cutoff, double Q, double peakGain) {
+        filterType = filtType;
+        filterCutoff = cutoff;
+        filterQ = Q;
+        filterGain = peakGain;
+        if (!coefficients.update(filtType, cutoff * context->sampleDuration, Q, peakGain)) return;
+        double &a0 = coefficients.value[0], &a1 = coefficients.value[1], &a2 = coefficients.value[2];
+        double &b1 = coefficients.value[3], &b2 = coefficients.value[4];
         double norm=0;
         double V = pow(10.0, abs(peakGain) / 20.0);
-        double K = tan(PI * cutoff / maxiSettings::sampleRate);
+        double K = tan(PI * cutoff * context->sampleDuration);
         switch (filtType) {
             case LOWPASS:
                 norm = 1.0 / (1.0 + K / Q + K * K);
@@ -875,9 +1292,15 @@ public:
                 break;
         }
     }
+protected:
+    void contextChanged() override {
+        if (filterCutoff > 0) set(filterType, filterCutoff, filterQ, filterGain);
+    }
+
 private:
-    double a0=0,a1=0,a2=0,b1=0,b2=0;
-    filterTypes filterType;
+    maxiFilterCoefficients<5> coefficients;     //a0, a1, a2, b1, b2
+    filterTypes filterType = LOWPASS;
+    double filterCutoff = 0, filterQ = 1, filterGain = 0;  //as last set, 0 cutoff if never set
     const double SQRT2 = sqrt(2.0);
     double v[3] = {0,0,0};
 };
@@ -904,7 +1327,7 @@ public:
 
 };
 
-class maxiLine {
+class maxiLine : public maxiContextUser {
 public:
     inline double play(double trigger) {
         if (!lineComplete) {
@@ -928,7 +1351,7 @@ public:
         lineValue = start;
         lineEnd = end;
         double lineMag = end - start;
-        double durInSamples = durationMs / 1000.0 * maxiSettings::sampleRate;
+        double durInSamples = durationMs * context->samplesPerMs;
         inc =  lineMag / durInSamples;
         triggered = false;
         lineComplete = false;
@@ -990,16 +1413,16 @@ public:
 
 //https://tutorials.siam.org/dsweb/cotutorial/index.php?s=3&p=0
 //https://www.complexity-explorables.org/explorables/ride-my-kuramotocycle/
-class maxiKuramotoOscillator {
+class maxiKuramotoOscillator : public maxiContextUser {
 public:
 
-    inline double play(double freq, double K, std::vector<double> phases) {
+    inline double play(double freq, double K, const std::vector<double> &phases) {
 
         double phaseAdj = 0;
         for(double v: phases) {
             phaseAdj += sin(v - phase);
         }
-        phase +=  dt * (freq + ((K / phases.size()) * phaseAdj));
+        phase +=  context->radiansPerHz * (freq + ((K / phases.size()) * phaseAdj));
         if (phase >= TWOPI) phase -= TWOPI;
         else if (phase <0) phase += TWOPI;
         return phase;
@@ -1008,52 +1431,50 @@ public:
     inline double getPhase() {return phase;}
 private:
     double phase=0.0;
-    double dt = TWOPI/maxiSettings::sampleRate;
 };
 
-//a local group of oscillators
-class maxiKuramotoOscillatorSet {
+//a local group of oscillators, all pulled towards their average (the mean field) rather than
+//towards each other one by one, which is the same thing but costs O(N) a sample rather than O(N^2).
+//Phases are held in cycles, side by side, so the update vectorises.
+class maxiKuramotoOscillatorSet : public maxiContextUser {
 public:
-    maxiKuramotoOscillatorSet(const size_t N) {
-        oscs.resize(N);
-        phases.resize(N);
-    };
-    void setPhases(const std::vector<double> &phases) {
-        size_t iOsc = 0;
-        for(double v: phases) {
-            oscs[iOsc].setPhase(v);
-            iOsc++;
-        }
-    }
+    maxiKuramotoOscillatorSet(const size_t N);
 
-    void setPhase(const double phase, const size_t oscillatorIdx) {
-        oscs[oscillatorIdx].setPhase(phase);
-    }
+    //phases in radians
+    void setPhases(const std::vector<double> &phases);
+    void setPhase(const double phase, const size_t oscillatorIdx);
 
     double getPhase(size_t i) {
-        return oscs[i].getPhase();
+        return phase[i] * TWOPI;
     }
 
     size_t size() {
-        return oscs.size();
+        return phase.size();
     }
 
-    double play(double freq, double K) {
-        double mix=0.0;
-        //gather phases
-        for(size_t i=0; i < phases.size(); i++) {
-            phases[i] = oscs[i].getPhase();
-        }
-        for(auto &v: oscs) {
-            mix += v.play(freq, K, phases);
-        }
-        return mix  / phases.size();
-    }
+    //each oscillator's own frequency is freq plus its offset in Hz, 0 until set. With no spread of
+    //frequencies the set always ends up in step.
+    void setFrequencyOffset(const double offset, const size_t oscillatorIdx);
+
+    //how far the oscillators are in step, from 0 (spread evenly around the cycle) to 1 (together),
+    //and the phase in radians of their average
+    double getCoherence();
+    double getMeanPhase();
 
+    //returns the mean of the phases in radians, after the step
+    double play(double freq, double K);
+    //the same, once per sample
+    void play(float *output, int numSamples, double freq, double K);
 
 protected:
-    std::vector<maxiKuramotoOscillator> oscs;
-    std::vector<double> phases;
+    float step(double freq, double K);
+    void updateMeanField();
+
+    std::vector<float> phase;           //in cycles, 0 to 1
+    std::vector<float> offset;          //in Hz
+    std::vector<float> sine, cosine;    //of each phase
+    float meanSine=0, meanCosine=0;
+    bool meanFieldValid=false;
 };
 
 //a single oscillator, updated according to phase information from remote oscillators
@@ -1066,31 +1487,19 @@ public:
     };
 
     void setPhase(const double phase, const size_t oscillatorIdx) {
-        oscs[oscillatorIdx].setPhase(phase);
+        maxiKuramotoOscillatorSet::setPhase(phase, oscillatorIdx);
         update=1;
     }
     void setPhases(const std::vector<double> &phases) {
-        size_t iOsc = 0;
-        for(double v: phases) {
-            oscs[iOsc].setPhase(v);
-            iOsc++;
-        }
+        maxiKuramotoOscillatorSet::setPhases(phases);
         update=1;
     }
 
+    //the oscillators only pull on each other on the sample after an update
     double play(double freq, double K) {
-        double mix=0.0;
-        //gather phases
-        if (update) {
-            for(size_t i=0; i < phases.size(); i++) {
-                phases[i] = oscs[i].getPhase();
-            }
-        }
-        for(auto &v: oscs) {
-            mix += v.play(freq, update? K : 0, phases);
-        }
+        const double mix = maxiKuramotoOscillatorSet::play(freq, update? K : 0);
         update=0;
-        return mix  / phases.size();
+        return mix;
     }
 
 		double getPhase(size_t i) {
@@ -1194,9 +1603,13 @@ public:
         return v;
     }
 
+    //one generator per thread, pass your own to seed it or keep it to one voice
     static bitsig noise() {
-        bitsig v = static_cast<bitsig>(rand());
-        return v;
+        static thread_local maxiRandom random;
+        return random.next();
+    }
+    static bitsig noise(maxiRandom &random) {
+        return random.next();
     }
 
     static double toSignal(const bitsig t) {
@@ -0,0 +1,355 @@
+/*
+  ==============================================================================
+
+    FMEngine.cpp
+    Created: 17 Oct 2026 6:12:37pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "FMEngine.h"
+#include "../Maximilian/maximilian.h"
+
+//==============================================================================
+FMEngine::Patch FMEngine::getFactoryPatch (int index)
+{
+    Patch p;
+
+    auto setOperator = [&p] (int op, float ratio, float attackSeconds, float decaySeconds, float sustain, float releaseSeconds)
+    {
+        p.operators[op].ratio = ratio;
+        p.operators[op].attackSeconds = attackSeconds;
+        p.operators[op].decaySeconds = decaySeconds;
+        p.operators[op].sustain = sustain;
+        p.operators[op].releaseSeconds = releaseSeconds;
+    };
+
+    switch (index)
+    {
+        case 1:     // bell: two stacks with inharmonic modulators
+            setOperator (0, 1.0f,  0.001f, 3.0f, 0.0f, 2.0f);
+            setOperator (1, 3.5f,  0.001f, 2.0f, 0.0f, 1.5f);
+            setOperator (2, 2.0f,  0.001f, 2.5f, 0.0f, 2.0f);
+            setOperator (3, 5.19f, 0.001f, 1.5f, 0.0f, 1.0f);
+            p.modulation[0][1] = 3.0f;
+            p.modulation[2][3] = 2.0f;
+            p.output[0] = 0.5f;
+            p.output[2] = 0.3f;
+            break;
+
+        case 2:     // brass: a three operator stack, the top one fed back on itself
+            setOperator (0, 1.0f, 0.03f, 0.5f, 0.8f, 0.15f);
+            setOperator (1, 1.0f, 0.06f, 0.4f, 0.6f, 0.15f);
+            setOperator (2, 1.0f, 0.02f, 0.3f, 0.7f, 0.15f);
+            p.modulation[0][1] = 2.5f;
+            p.modulation[1][2] = 1.0f;
+            p.modulation[2][2] = 1.2f;
+            p.output[0] = 0.8f;
+            break;
+
+        case 3:     // bass: one pair, the modulator fed back and quick to fade
+            setOperator (0, 1.0f, 0.001f, 1.0f, 0.3f, 0.08f);
+            setOperator (1, 1.0f, 0.001f, 0.2f, 0.1f, 0.08f);
+            p.modulation[0][1] = 3.0f;
+            p.modulation[1][1] = 0.8f;
+            p.output[0] = 0.8f;
+            break;
+
+        default:    // electric piano: a soft pair for the body and a high ratio pair for the tine
+            setOperator (0, 1.0f,  0.001f, 2.0f,  0.0f,  0.3f);
+            setOperator (1, 1.0f,  0.001f, 0.8f,  0.15f, 0.3f);
+            setOperator (2, 1.0f,  0.001f, 1.2f,  0.0f,  0.3f);
+            setOperator (3, 14.0f, 0.001f, 0.08f, 0.0f,  0.1f);
+            p.modulation[0][1] = 1.8f;
+            p.modulation[2][3] = 0.8f;
+            p.output[0] = 0.5f;
+            p.output[2] = 0.35f;
+            break;
+    }
+
+    return p;
+}
+
+const char* FMEngine::getFactoryPatchName (int index)
+{
+    static const char* const names[numFactoryPatches] = { "Electric Piano", "Bell", "Brass", "Bass" };
+    return names[jlimit (0, numFactoryPatches - 1, index)];
+}
+
+//==============================================================================
+FMEngine::FMEngine()
+{
+    std::fill (frequency, frequency + maxVoices, 0.0);
+
+    for (int op = 0; op < numOperators; ++op)
+    {
+        std::fill (phase[op], phase[op] + maxVoices, 0u);
+        std::fill (increment[op], increment[op] + maxVoices, 0u);
+        std::fill (output[op], output[op] + maxVoices, 0.0f);
+        std::fill (lastOutput[op], lastOutput[op] + maxVoices, 0.0f);
+        std::fill (envelope[op], envelope[op] + maxVoices, 0.0f);
+        std::fill (envelopeTarget[op], envelopeTarget[op] + maxVoices, 0.0f);
+        std::fill (envelopeRate[op], envelopeRate[op] + maxVoices, 0.0f);
+        std::fill (stage[op], stage[op] + maxVoices, (uint8) release);
+    }
+
+    setPatch (getFactoryPatch (0));
+}
+
+void FMEngine::setSampleRate (double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    setPatch (compiled.patch);
+}
+
+void FMEngine::setPatch (const Patch& newPatch)
+{
+    setPatch (CompiledPatch (newPatch, sampleRate));
+}
+
+void FMEngine::setPatch (const CompiledPatch& newPatch) noexcept
+{
+    bool ratioChanged[numOperators];
+    const bool rateChanged = compiled.incrementScale != newPatch.incrementScale;
+
+    for (int op = 0; op < numOperators; ++op)
+        ratioChanged[op] = rateChanged || compiled.patch.operators[op].ratio != newPatch.patch.operators[op].ratio;
+
+    if (newPatch.sampleRate == sampleRate)
+        compiled = newPatch;
+    else
+        compiled = CompiledPatch (newPatch.patch, sampleRate);
+
+    for (int i = 0; i < maxVoices; ++i)
+    {
+        updateIncrements (i, ratioChanged);
+
+        for (int op = 0; op < numOperators; ++op)
+            updateEnvelope (op, i);
+    }
+}
+
+FMEngine::CompiledPatch::CompiledPatch (const Patch& sourcePatch, double rate)
+    : patch (sourcePatch),
+      sampleRate (rate),
+      incrementScale (4294967296.0 / rate)
+{
+    // an operator is needed if it's heard or it modulates one that is, work back from the outputs
+    bool needed[numOperators];
+
+    for (int op = 0; op < numOperators; ++op)
+        needed[op] = patch.output[op] != 0.0f;
+
+    for (bool changed = true; changed;)
+    {
+        changed = false;
+
+        for (int to = 0; to < numOperators; ++to)
+            for (int from = 0; from < numOperators; ++from)
+                if (needed[to] && ! needed[from] && patch.modulation[to][from] != 0.0f)
+                    needed[from] = changed = true;
+    }
+
+    const float radiansToCycles = 1.0f / MathConstants<float>::twoPi;
+
+    for (int op = numOperators; --op >= 0;)
+    {
+        if (! needed[op])
+            continue;
+
+        order[numActive++] = op;
+
+        for (int from = 0; from < numOperators; ++from)
+        {
+            if (from != op && patch.modulation[op][from] != 0.0f)
+            {
+                sources[op][numSources[op]] = from;
+                depth[op][numSources[op]] = patch.modulation[op][from] * radiansToCycles;
+                ++numSources[op];
+            }
+        }
+
+        // averaging the last two samples stops strong feedback flipping between two states
+        feedback[op] = patch.modulation[op][op] * radiansToCycles * 0.5f;
+    }
+
+    auto coefficient = [rate] (float seconds)
+    {
+        return (float) (1.0 - std::exp (-1.0 / (jmax (seconds, 0.0001f) * rate)));
+    };
+
+    for (int op = 0; op < numOperators; ++op)
+    {
+        attackRate[op]  = coefficient (patch.operators[op].attackSeconds);
+        decayRate[op]   = coefficient (patch.operators[op].decaySeconds);
+        releaseRate[op] = coefficient (patch.operators[op].releaseSeconds);
+    }
+}
+
+void FMEngine::updateIncrements (int index, const bool* changed) noexcept
+{
+    // the same rounding as maxiFixedPointOsc::phaseIncrement, with the divide done once in the patch
+    for (int op = 0; op < numOperators; ++op)
+        if (changed == nullptr || changed[op])
+            increment[op][index] = (uint32) (int64) std::floor (frequency[index] * compiled.patch.operators[op].ratio
+                                                                  * compiled.incrementScale + 0.5);
+}
+
+void FMEngine::updateEnvelope (int op, int index) noexcept
+{
+    switch (stage[op][index])
+    {
+        case attack:    envelopeTarget[op][index] = 1.0f;                                   envelopeRate[op][index] = compiled.attackRate[op];  break;
+        case decay:     envelopeTarget[op][index] = compiled.patch.operators[op].sustain;   envelopeRate[op][index] = compiled.decayRate[op];   break;
+        default:        envelopeTarget[op][index] = 0.0f;                                   envelopeRate[op][index] = compiled.releaseRate[op]; break;
+    }
+}
+
+//==============================================================================
+void FMEngine::startVoice (int index, double newFrequency)
+{
+    jassert (isPositiveAndBelow (index, maxVoices));
+
+    frequency[index] = newFrequency;
+    updateIncrements (index, nullptr);
+
+    for (int op = 0; op < numOperators; ++op)
+    {
+        phase[op][index] = 0;
+        output[op][index] = 0.0f;
+        lastOutput[op][index] = 0.0f;
+        envelope[op][index] = 0.0f;
+        stage[op][index] = attack;
+        updateEnvelope (op, index);
+    }
+}
+
+void FMEngine::releaseVoice (int index)
+{
+    for (int op = 0; op < numOperators; ++op)
+    {
+        stage[op][index] = release;
+        updateEnvelope (op, index);
+    }
+}
+
+bool FMEngine::isVoiceSilent (int index, float threshold) const noexcept
+{
+    for (int k = 0; k < compiled.numActive; ++k)
+    {
+        const int op = compiled.order[k];
+        const float heard = std::abs (compiled.patch.operators[op].level * compiled.patch.output[op]);
+
+        if (envelope[op][index] * heard >= threshold)
+            return false;
+    }
+
+    return true;
+}
+
+float FMEngine::getReleaseSeconds() const noexcept
+{
+    float longest = 0.0f;
+
+    for (int op = 0; op < numOperators; ++op)
+        if (compiled.patch.output[op] != 0.0f)
+            longest = jmax (longest, compiled.patch.operators[op].releaseSeconds);
+
+    return longest;
+}
+
+void FMEngine::advanceStages (int first) noexcept
+{
+    // attacks hand over to their decays once per chunk, which keeps the sample loop free of branches
+    for (int op = 0; op < numOperators; ++op)
+    {
+        for (int i = first; i < first + laneWidth; ++i)
+        {
+            if (stage[op][i] == attack && envelope[op][i] >= 0.99f)
+            {
+                stage[op][i] = decay;
+                updateEnvelope (op, i);
+            }
+        }
+    }
+}
+
+void FMEngine::renderGroup (int first, float* out, int numSamples) noexcept
+{
+    advanceStages (first);
+
+    // local copies of the operators in use, so the compiler can keep them in vector registers
+    uint32 p[numOperators][laneWidth], inc[numOperators][laneWidth];
+    float y[numOperators][laneWidth], y1[numOperators][laneWidth];
+    float env[numOperators][laneWidth], tgt[numOperators][laneWidth], r[numOperators][laneWidth];
+    float gain[numOperators], mix[numOperators];
+
+    for (int k = 0; k < compiled.numActive; ++k)
+    {
+        const int op = compiled.order[k];
+        gain[op] = compiled.patch.operators[op].level;
+        mix[op] = compiled.patch.output[op];
+
+        for (int lane = 0; lane < laneWidth; ++lane)
+        {
+            p[op][lane]   = phase[op][first + lane];
+            inc[op][lane] = increment[op][first + lane];
+            y[op][lane]   = output[op][first + lane];
+            y1[op][lane]  = lastOutput[op][first + lane];
+            env[op][lane] = envelope[op][first + lane];
+            tgt[op][lane] = envelopeTarget[op][first + lane];
+            r[op][lane]   = envelopeRate[op][first + lane];
+        }
+    }
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        float* o = out + sample * laneWidth;
+
+        for (int lane = 0; lane < laneWidth; ++lane)
+            o[lane] = 0.0f;
+
+        for (int k = 0; k < compiled.numActive; ++k)
+        {
+            const int op = compiled.order[k];
+            float modulation[laneWidth];
+
+            for (int lane = 0; lane < laneWidth; ++lane)
+                modulation[lane] = compiled.feedback[op] * (y[op][lane] + y1[op][lane]);
+
+            for (int s = 0; s < compiled.numSources[op]; ++s)
+            {
+                const float* from = y[compiled.sources[op][s]];
+                const float d = compiled.depth[op][s];
+
+                for (int lane = 0; lane < laneWidth; ++lane)
+                    modulation[lane] += d * from[lane];
+            }
+
+            for (int lane = 0; lane < laneWidth; ++lane)
+            {
+                env[op][lane] += (tgt[op][lane] - env[op][lane]) * r[op][lane];
+                y1[op][lane] = y[op][lane];
+                // same signed phase read as VoiceBank::renderGroup, the modulation just moves it
+                y[op][lane] = maxiFastMath::sinCycle ((float) (int32) p[op][lane] * (1.0f / 4294967296.0f) + modulation[lane])
+                                * env[op][lane] * gain[op];
+                p[op][lane] += inc[op][lane];
+                o[lane] += y[op][lane] * mix[op];
+            }
+        }
+    }
+
+    for (int k = 0; k < compiled.numActive; ++k)
+    {
+        const int op = compiled.order[k];
+
+        for (int lane = 0; lane < laneWidth; ++lane)
+        {
+            phase[op][first + lane]      = p[op][lane];
+            output[op][first + lane]     = y[op][lane];
+            lastOutput[op][first + lane] = y1[op][lane];
+            envelope[op][first + lane]   = env[op][lane];
+        }
+    }
+}
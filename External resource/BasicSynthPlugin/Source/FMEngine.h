@@ -0,0 +1,138 @@
+/*
+  ==============================================================================
+
+    FMEngine.h
+    Created: 17 Oct 2026 6:12:37pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Six operator phase modulation voices for the VoiceBank.
+
+    Each operator is a sine on a 32 bit phase accumulator with its own envelope.
+    A routing matrix says how far each operator's output moves the phase of every
+    other operator. The diagonal of the matrix is feedback.
+
+    State is held per operator per voice with voices side by side, so
+    renderGroup() advances laneWidth voices together the same way
+    VoiceBank::renderGroup() does for its sines.
+*/
+class FMEngine
+{
+public:
+    static constexpr int numOperators = 6;
+    static constexpr int maxVoices = 256;   // matches VoiceBank::maxVoices
+    static constexpr int laneWidth = 8;     // matches VoiceBank::laneWidth
+
+    struct Operator
+    {
+        float ratio = 1.0f;             // of the note frequency
+        float level = 1.0f;
+        float attackSeconds = 0.001f;   // one pole time constants, like VoiceBank::setEnvelope
+        float decaySeconds = 1.0f;
+        float sustain = 1.0f;           // fraction of the peak held until note off
+        float releaseSeconds = 0.1f;    // the note lasts until the heard operators have faded, see VoiceBank
+    };
+
+    struct Patch
+    {
+        Operator operators[numOperators];
+
+        /** modulation[to][from] is the peak phase deviation, in radians, that operator
+            'from' gives operator 'to'. Operators are computed from the last to the first, so
+            modulation from a higher numbered operator uses this sample's output and
+            modulation from the same or a lower one uses the last sample's.
+        */
+        float modulation[numOperators][numOperators] = {};
+
+        /** How much of each operator goes to the voice output, 0 for pure modulators. */
+        float output[numOperators] = {};
+    };
+
+    /** A patch worked out for one sample rate, in the form renderGroup() wants: the operators
+        that make sound or modulate one that does, in the order they are computed, and only the
+        non-zero connections into each. Building one takes a few exp() calls, so do it off the
+        audio thread and hand it to setPatch() there.
+    */
+    struct CompiledPatch
+    {
+        CompiledPatch() = default;
+        CompiledPatch (const Patch& sourcePatch, double sampleRate);
+
+        Patch patch;
+        double sampleRate = 0.0;            // 0 until it's been compiled
+        double incrementScale = 0.0;        // phase increment per Hz
+
+        int order[numOperators] = {};
+        int numActive = 0;
+        int numSources[numOperators] = {};
+        int sources[numOperators][numOperators] = {};
+        float depth[numOperators][numOperators] = {};   // in cycles
+        float feedback[numOperators] = {};              // in cycles, applied to the average of the last two samples
+        float attackRate[numOperators] = {}, decayRate[numOperators] = {}, releaseRate[numOperators] = {};
+    };
+
+    static constexpr int numFactoryPatches = 4;
+    static Patch getFactoryPatch (int index);
+    static const char* getFactoryPatchName (int index);
+
+    FMEngine();
+
+    void setSampleRate (double newSampleRate);
+
+    /** Takes effect straight away for sounding notes too. Must be called from the audio
+        thread or before playback starts. This one compiles the patch, so it's better to
+        pass the audio thread a CompiledPatch.
+    */
+    void setPatch (const Patch& newPatch);
+
+    /** Doesn't allocate or call exp(), unless the patch was compiled for another sample
+        rate and has to be compiled again.
+    */
+    void setPatch (const CompiledPatch& newPatch) noexcept;
+    const Patch& getPatch() const noexcept          { return compiled.patch; }
+
+    /** Starts the operators from silence, phases and envelopes both. */
+    void startVoice (int index, double frequency);
+    void releaseVoice (int index);
+
+    /** True once every operator that goes to the output is quieter than threshold. */
+    bool isVoiceSilent (int index, float threshold) const noexcept;
+
+    /** The longest release of the operators that go to the output. */
+    float getReleaseSeconds() const noexcept;
+
+    /** Writes numSamples of the voices first to first + laneWidth - 1 into out,
+        interleaved as [sample][lane]. numSamples is at most VoiceBank::chunkSize.
+    */
+    void renderGroup (int first, float* out, int numSamples) noexcept;
+
+private:
+    enum Stage : uint8 { attack = 0, decay, release };
+
+    void updateIncrements (int index, const bool* changed) noexcept;
+    void updateEnvelope (int op, int index) noexcept;
+    void advanceStages (int first) noexcept;
+
+    CompiledPatch compiled;
+    double sampleRate = 44100.0;
+
+    // per operator per voice
+    double frequency[maxVoices];
+    alignas (16) uint32 phase[numOperators][maxVoices];
+    alignas (16) uint32 increment[numOperators][maxVoices];
+    alignas (16) float output[numOperators][maxVoices];
+    alignas (16) float lastOutput[numOperators][maxVoices];
+    alignas (16) float envelope[numOperators][maxVoices];
+    alignas (16) float envelopeTarget[numOperators][maxVoices];
+    alignas (16) float envelopeRate[numOperators][maxVoices];
+    uint8 stage[numOperators][maxVoices];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FMEngine)
+};
@@ -18,10 +18,50 @@ BasicSynthAudioProcessorEditor::BasicSynthAudioProcessorEditor (BasicSynthAudioP
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
     setSize (400, 300);
+
+    // drain anything queued while the editor was closed so the first frame is current
+    TelemetryFrame stale;
+    while (processor.getTelemetry().pop (stale)) {}
+
+    startTimerHz (30);
 }
 
 BasicSynthAudioProcessorEditor::~BasicSynthAudioProcessorEditor()
 {
+    stopTimer();
+}
+
+void BasicSynthAudioProcessorEditor::timerCallback()
+{
+    TelemetryFrame frame;
+    bool gotFrame = false;
+    uint32 worst = 0;
+    double processedSeconds = 0.0, audioSeconds = 0.0;
+
+    while (processor.getTelemetry().pop (frame))
+    {
+        for (int channel = 0; channel < frame.numChannels; ++channel)
+            peakHold[channel] = jmax (peakHold[channel], frame.peak[channel]);
+
+        worst = jmax (worst, frame.worstNanoseconds);
+        processedSeconds += frame.processNanoseconds * 1.0e-9;
+        audioSeconds += frame.numSamples / processor.getSampleRate();
+
+        latest = frame;
+        gotFrame = true;
+    }
+
+    if (! gotFrame)
+        return;
+
+    worstNanoseconds = worst;
+    load = audioSeconds > 0.0 ? processedSeconds / audioSeconds : 0.0;
+
+    repaint();
+
+    // let the held peaks fall back for the next frame
+    for (auto& p : peakHold)
+        p *= 0.8f;
 }
 
 //==============================================================================
@@ -30,9 +70,40 @@ void BasicSynthAudioProcessorEditor::paint (Graphics& g)
     // (Our component is opaque, so we must completely fill the background with a solid colour)
     g.fillAll (getLookAndFeel().findColour (ResizableWindow::backgroundColourId));
 
+    auto area = getLocalBounds().reduced (10);
+
     g.setColour (Colours::white);
     g.setFont (15.0f);
-    g.drawFittedText ("Hello World!", getLocalBounds(), Justification::centred, 1);
+
+    auto text = area.removeFromTop (80);
+    g.drawFittedText ("Voices: " + String (latest.numActiveVoices)
+                        + "\nprocessBlock: " + String (latest.processNanoseconds / (1000.0 * latest.numBlocks), 1) + "us (worst "
+                        + String (worstNanoseconds / 1000.0, 1) + "us)"
+                        + "\nLoad: " + String (load * 100.0, 1) + "%"
+                        + "\nXruns: " + String ((int) latest.numXruns),
+                      text, Justification::topLeft, 4);
+
+    if (latest.numChannels == 0)
+        return;
+
+    // one meter per channel: rms filled, peak as a line
+    area.removeFromTop (10);
+    const int meterWidth = area.getWidth() / latest.numChannels;
+
+    for (int channel = 0; channel < latest.numChannels; ++channel)
+    {
+        auto meter = area.removeFromLeft (meterWidth).reduced (2, 0).toFloat();
+        const auto height = meter.getHeight();
+
+        g.setColour (Colours::darkgrey);
+        g.fillRect (meter);
+
+        g.setColour (Colours::limegreen);
+        g.fillRect (meter.withTop (meter.getBottom() - height * jmin (1.0f, latest.rms[channel])));
+
+        g.setColour (peakHold[channel] >= 1.0f ? Colours::red : Colours::yellow);
+        g.fillRect (meter.withTop (meter.getBottom() - height * jmin (1.0f, peakHold[channel])).withHeight (2.0f));
+    }
 }
 
 void BasicSynthAudioProcessorEditor::resized()
@@ -16,7 +16,8 @@
 //==============================================================================
 /**
 */
-class BasicSynthAudioProcessorEditor  : public AudioProcessorEditor
+class BasicSynthAudioProcessorEditor  : public AudioProcessorEditor,
+                                        private Timer
 {
 public:
     BasicSynthAudioProcessorEditor (BasicSynthAudioProcessor&);
@@ -27,9 +28,17 @@ public:
     void resized() override;
 
 private:
+    void timerCallback() override;
+
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     BasicSynthAudioProcessor& processor;
 
+    // telemetry gathered since the last repaint
+    TelemetryFrame latest;
+    float peakHold[TelemetryFrame::maxChannels] = {};
+    uint32 worstNanoseconds = 0;
+    double load = 0.0;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BasicSynthAudioProcessorEditor)
 };
@@ -25,12 +25,9 @@ BasicSynthAudioProcessor::BasicSynthAudioProcessor()
                        )
 #endif
 {
-    mySynth.clearVoices();
-
-    for (int i = 0; i < 5; i++)
-    {
-        mySynth.addVoice(new SynthVoice());
-    }
+    requestedState.polyphony = defaultPolyphony;
+    requestedState.compileFMPatch (getSampleRate());
+    applyState(requestedState);
 
     mySynth.clearSounds();
     mySynth.addSound(new SynthSound());
@@ -45,6 +42,10 @@ BasicSynthAudioProcessor::BasicSynthAudioProcessor()
 
 BasicSynthAudioProcessor::~BasicSynthAudioProcessor()
 {
+    presets.stopLoading();
+
+    delete pendingState.exchange(nullptr);
+    collectRetiredState();
 }
 
 //==============================================================================
@@ -82,27 +83,28 @@ bool BasicSynthAudioProcessor::isMidiEffect() const
 
 double BasicSynthAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return tailSeconds.load (std::memory_order_relaxed);
 }
 
 int BasicSynthAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    return jmax (1, presets.getNumPresets());   // NB: some hosts don't cope very well if you tell them there are 0 programs,
+                                                // so this should be at least 1, even if you're not really implementing programs.
 }
 
 int BasicSynthAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return getRequestedState().program;
 }
 
 void BasicSynthAudioProcessor::setCurrentProgram (int index)
 {
+    presets.load (index);
 }
 
 const String BasicSynthAudioProcessor::getProgramName (int index)
 {
-    return {};
+    return presets.getName (index);
 }
 
 void BasicSynthAudioProcessor::changeProgramName (int index, const String& newName)
@@ -112,9 +114,14 @@ void BasicSynthAudioProcessor::changeProgramName (int index, const String& newNa
 //==============================================================================
 void BasicSynthAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    ignoreUnused(samplesPerBlock);                          // remove data from last key press
     lastSampleRate = sampleRate;                            // store temp sampleRate 
+    numXruns = 0;
+    dspContext.setup(sampleRate, getTotalNumOutputChannels(), samplesPerBlock);
     mySynth.setCurrentPlaybackSampleRate(lastSampleRate);   // attach sampleRate to synth
+
+    SpatialEncoder::Layout layout = SpatialEncoder::none;
+    SpatialEncoder::getLayoutFor(getBusesLayout().getMainOutputChannelSet(), layout);
+    mySynth.setSpatialLayout(layout);
 }
 
 void BasicSynthAudioProcessor::releaseResources()
@@ -130,10 +137,10 @@ bool BasicSynthAudioProcessor::isBusesLayoutSupported (const BusesLayout& layout
     ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    if (layouts.getMainOutputChannelSet() != AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != AudioChannelSet::stereo())
+    // mono, stereo, quad, 5.1 and first to third order ambisonics
+    SpatialEncoder::Layout layout;
+
+    if (! SpatialEncoder::getLayoutFor (layouts.getMainOutputChannelSet(), layout))
         return false;
 
     // This checks if the input layout matches the output layout
@@ -149,9 +156,25 @@ bool BasicSynthAudioProcessor::isBusesLayoutSupported (const BusesLayout& layout
 
 void BasicSynthAudioProcessor::processBlock (AudioBuffer<float>& buffer, MidiBuffer& midiMessages)
 {
+    ScopedNoDenormals noDenormals;
+    const int64 startTicks = Time::getHighResolutionTicks();
+
+    applyPendingState();
+
+    // The host can hand us a buffer full of garbage, so even a silent block has to be
+    // zeroed. Everything else is skipped while no voice is sounding and no MIDI arrives.
     buffer.clear();
-    mySynth.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
-    buffer.applyGain(*level);
+
+    const bool nothingToDo = midiMessages.isEmpty() && ! mySynth.isSounding();
+    silent.store(nothingToDo, std::memory_order_relaxed);
+
+    if (! nothingToDo)
+    {
+        mySynth.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
+        buffer.applyGain(*level);
+    }
+
+    publishTelemetry(buffer, startTicks);
 
 
     /*
@@ -183,6 +206,39 @@ void BasicSynthAudioProcessor::processBlock (AudioBuffer<float>& buffer, MidiBuf
     */
 }
 
+void BasicSynthAudioProcessor::publishTelemetry(const AudioBuffer<float>& buffer, int64 startTicks)
+{
+    TelemetryFrame frame;
+    frame.numChannels = jmin(buffer.getNumChannels(), (int) TelemetryFrame::maxChannels);
+    frame.numSamples = buffer.getNumSamples();
+    frame.numActiveVoices = mySynth.getVoiceBank().getNumActiveVoices();
+
+    if (! isSilent())
+    {
+        for (int channel = 0; channel < frame.numChannels; ++channel)
+        {
+            frame.peak[channel] = buffer.getMagnitude(channel, 0, frame.numSamples);
+            frame.rms[channel] = buffer.getRMSLevel(channel, 0, frame.numSamples);
+        }
+    }
+
+    const double tookSeconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks);
+    const double blockSeconds = frame.numSamples / lastSampleRate;
+
+    // a block that took longer to make than it lasts would have glitched in a live host
+    if (tookSeconds > blockSeconds && ! isNonRealtime())
+    {
+        ++numXruns;
+        log->post(RealtimeLog::Event::overload, roundToInt(tookSeconds * 1.0e6), roundToInt(blockSeconds * 1.0e6));
+    }
+
+    frame.processNanoseconds = (uint32) jmin(tookSeconds * 1.0e9, (double) std::numeric_limits<uint32>::max());
+    frame.worstNanoseconds = frame.processNanoseconds;
+    frame.numXruns = numXruns;
+
+    telemetry.push(frame);
+}
+
 //==============================================================================
 bool BasicSynthAudioProcessor::hasEditor() const
 {
@@ -197,15 +253,103 @@ AudioProcessorEditor* BasicSynthAudioProcessor::createEditor()
 //==============================================================================
 void BasicSynthAudioProcessor::getStateInformation (MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    auto state = getRequestedState();
+    state.level = *level;   // may have been automated since the state was queued
+    state.writeTo (destData);
 }
 
 void BasicSynthAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    auto state = std::make_unique<SynthState>();
+
+    if (SynthState::readFrom (data, sizeInBytes, *state))
+        queueState (std::move (state));
+}
+
+//==============================================================================
+void BasicSynthAudioProcessor::queueState (std::unique_ptr<SynthState> newState)
+{
+    jassert (newState != nullptr);
+    newState->sanitise();
+
+    // here on the preset loader or message thread, so applyState() only copies it in. If the rate
+    // changes before it's applied the bank compiles it again.
+    newState->compileFMPatch (getSampleRate());
+
+    *level = newState->level;
+
+    // free the states the audio thread has finished with
+    collectRetiredState();
+
+    // under the lock, so with two callers at once the last one to take it wins both here and on
+    // the audio thread. If the audio thread hasn't picked up the previous state yet it never
+    // will, this one replaces it.
+    const ScopedLock sl (requestedStateLock);
+    requestedState = *newState;
+    delete pendingState.exchange (newState.release(), std::memory_order_acq_rel);
+}
+
+SynthState BasicSynthAudioProcessor::getRequestedState() const
+{
+    const ScopedLock sl (requestedStateLock);
+    return requestedState;
+}
+
+void BasicSynthAudioProcessor::collectRetiredState()
+{
+    for (auto& slot : retiredStates)
+        delete slot.exchange (nullptr, std::memory_order_acquire);
+}
+
+void BasicSynthAudioProcessor::applyPendingState() noexcept
+{
+    // only the audio thread fills slots, so one found empty here stays empty until it's used
+    for (auto& slot : retiredStates)
+    {
+        if (slot.load (std::memory_order_acquire) != nullptr)
+            continue;
+
+        if (auto* state = pendingState.exchange (nullptr, std::memory_order_acq_rel))
+        {
+            applyState (*state);
+            slot.store (state, std::memory_order_release);
+        }
+
+        return;
+    }
+}
+
+void BasicSynthAudioProcessor::applyState (const SynthState& state) noexcept
+{
+    mySynth.setPolyphony (state.polyphony);
+    mySynth.setStealMode ((PolySynth::StealMode) state.stealMode);
+    mySynth.getVoiceBank().setEnvelope (state.attackSeconds, state.releaseSeconds);
+    mySynth.getVoiceBank().setVoiceType ((VoiceBank::VoiceType) state.voiceType);
+    mySynth.getVoiceBank().setFMPatch (state.compiledFMPatch);
+    tailSeconds.store (mySynth.getVoiceBank().getTailSeconds(), std::memory_order_relaxed);
+}
+
+//==============================================================================
+void BasicSynthAudioProcessor::setPolyphony (int numVoices)
+{
+    auto state = std::make_unique<SynthState> (getRequestedState());
+    state->polyphony = numVoices;
+    queueState (std::move (state));
+}
+
+int BasicSynthAudioProcessor::getPolyphony() const
+{
+    return getRequestedState().polyphony;
+}
+
+void BasicSynthAudioProcessor::setNumRenderThreads (int numThreads)
+{
+    mySynth.setNumRenderThreads (numThreads);
+}
+
+int BasicSynthAudioProcessor::getNumRenderThreads() const
+{
+    return mySynth.getNumRenderThreads();
 }
 
 //==============================================================================
@@ -12,7 +12,12 @@
 
 #include <JuceHeader.h>
 #include "SynthSound.h"
-#include "SynthVoice.h"
+#include "PolySynth.h"
+#include "RealtimeLog.h"
+#include "TelemetryFifo.h"
+#include "SynthState.h"
+#include "PresetBank.h"
+#include "../Maximilian/maxiContext.h"
 
 //==============================================================================
 /**
@@ -58,13 +63,69 @@ public:
     void getStateInformation (MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    //==============================================================================
+    // Hands a complete state to the audio thread, which swaps it in at the start of
+    // its next block. Call from any thread except the audio thread.
+    void queueState (std::unique_ptr<SynthState> newState);
+
+    // The state most recently queued, which the audio thread may not have picked up yet.
+    SynthState getRequestedState() const;
+
+    PresetBank& getPresets() noexcept { return presets; }
+
+    // These queue a new state, so they take effect at the next block.
+    void setPolyphony (int numVoices);
+    int getPolyphony() const;
+
+    // Extra threads used to render voices, 0 (the default) renders on the audio thread.
+    // Takes effect at once and can be called while playing, but not from the audio thread.
+    void setNumRenderThreads (int numThreads);
+    int getNumRenderThreads() const;
+
+    static constexpr int defaultPolyphony = 32;
+
+    // True if the last processBlock had no sounding voices and skipped rendering.
+    bool isSilent() const noexcept { return silent.load(std::memory_order_relaxed); }
+
+    // Per block measurements, only the editor should read from this.
+    TelemetryFifo& getTelemetry() noexcept { return telemetry; }
+
+    // The rate this instance runs at. Maximilian ugens it owns should be bound to this with
+    // setContext() rather than use the process-wide default, which another instance may change.
+    const maxiContext& getDSPContext() const noexcept { return dspContext; }
+
 private:
-    Synthesiser mySynth;
-    SynthVoice* myVoice;
+    PolySynth mySynth;
+    std::atomic<bool> silent { true };
+    std::atomic<double> tailSeconds { 0.0 };    // of the applied state, for the host
+    SharedResourcePointer<RealtimeLog> log;
+    TelemetryFifo telemetry;
+    uint32 numXruns = 0;
+
+    void publishTelemetry(const AudioBuffer<float>& buffer, int64 startTicks);
+
+    // The audio thread takes pendingState with a single exchange, applies it and parks it in
+    // a free retiredStates slot, and the next queueState() deletes it there. Nothing is ever
+    // allocated or freed on the audio thread, and it never waits for the message side: between
+    // two collections it can retire at most the state it took just before the first one and
+    // the state that queueState() left, so there is always a slot free.
+    void applyPendingState() noexcept;
+    void applyState(const SynthState& state) noexcept;
+    void collectRetiredState();
+
+    static constexpr int numRetiredStates = 4;
+    std::atomic<SynthState*> pendingState { nullptr };
+    std::atomic<SynthState*> retiredStates[numRetiredStates] {};
+
+    CriticalSection requestedStateLock;
+    SynthState requestedState;
+
+    PresetBank presets { [this] (std::unique_ptr<SynthState> state) { queueState(std::move(state)); } };
 
     AudioParameterFloat* level;
     
     double lastSampleRate;
+    maxiContext dspContext;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BasicSynthAudioProcessor)
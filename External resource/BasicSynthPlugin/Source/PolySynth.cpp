@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+    PolySynth.cpp
+    Created: 17 Oct 2026 10:40:51am
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "PolySynth.h"
+#include "SynthVoice.h"
+
+//==============================================================================
+PolySynth::PolySynth()
+{
+    setNoteStealingEnabled (true);
+
+    for (int i = 0; i < VoiceBank::maxVoices; ++i)
+        addVoice (new SynthVoice (bank, i, *log));
+
+    bank.setNumVoices (VoiceBank::maxVoices);
+}
+
+void PolySynth::setPolyphony (int numVoices)
+{
+    numVoices = jlimit (1, (int) VoiceBank::maxVoices, numVoices);
+
+    // the bank cuts any notes above the new limit, their voices give them up here
+    bank.setNumVoices (numVoices);
+
+    for (int i = numVoices; i < voices.size(); ++i)
+        static_cast<SynthVoice*> (voices.getUnchecked (i))->updateTail();
+}
+
+void PolySynth::setNumRenderThreads (int numThreads)
+{
+    renderPool.setNumThreads (numThreads, lock);
+}
+
+void PolySynth::handleController (int midiChannel, int controllerNumber, int controllerValue)
+{
+    if (controllerNumber == azimuthController || controllerNumber == elevationController)
+    {
+        const int index = jlimit (1, 16, midiChannel) - 1;
+
+        if (controllerNumber == azimuthController)
+            channelAzimuth[index] = (64 - controllerValue) * (MathConstants<float>::pi / 64.0f);
+        else
+            channelElevation[index] = (jmin (controllerValue, 127) - 64) * (MathConstants<float>::halfPi / 63.0f);
+
+        channelElevation[index] = jlimit (-MathConstants<float>::halfPi, MathConstants<float>::halfPi, channelElevation[index]);
+        bank.setChannelPosition (index + 1, channelAzimuth[index], channelElevation[index]);
+
+        // notes already sounding on the channel move too
+        for (auto* voice : voices)
+            if (voice->isPlayingChannel (midiChannel))
+                bank.setVoicePosition (static_cast<SynthVoice*> (voice)->getBankIndex(), channelAzimuth[index], channelElevation[index]);
+    }
+
+    Synthesiser::handleController (midiChannel, controllerNumber, controllerValue);
+}
+
+void PolySynth::setCurrentPlaybackSampleRate (double sampleRate)
+{
+    Synthesiser::setCurrentPlaybackSampleRate (sampleRate);
+    bank.setSampleRate (sampleRate);
+}
+
+//==============================================================================
+void PolySynth::renderVoices (AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+    // the pool mixes to mono, spatial layouts always render on this thread
+    if (renderPool.getNumThreads() > 0 && ! bank.isSpatial())
+        renderPool.render (outputAudio, startSample, numSamples);
+    else
+        bank.render (outputAudio, startSample, numSamples);
+
+    firstUnrenderedStart = bank.getNextStartOrder();
+
+    // hand voices whose tails have finished back to the Synthesiser
+    if (bank.retireSilentVoices() > 0)
+        for (auto* voice : voices)
+            static_cast<SynthVoice*> (voice)->updateTail();
+}
+
+SynthesiserVoice* PolySynth::findVoiceToSteal (SynthesiserSound* soundToPlay, int /*midiChannel*/, int midiNoteNumber) const
+{
+    SynthesiserVoice* best = nullptr;
+    int bestIndex = -1;
+
+    // how loud a voice is or is heading for, so a note still in its attack isn't mistaken for a quiet one
+    auto loudness = [this] (int index) { return jmax (bank.getLevel (index), bank.getTarget (index)); };
+
+    for (auto* voice : voices)
+    {
+        if (! voice->canPlaySound (soundToPlay))
+            continue;
+
+        const int index = static_cast<SynthVoice*> (voice)->getBankIndex();
+
+        if (bank.isVoiceActive (index) && bank.getStartOrder (index) >= firstUnrenderedStart)
+            continue;
+
+        if (best == nullptr)
+        {
+            best = voice;
+            bestIndex = index;
+            continue;
+        }
+
+        const bool older = bank.getStartOrder (index) < bank.getStartOrder (bestIndex);
+
+        if (stealMode == stealQuietest)
+        {
+            const bool releasing = bank.isVoiceReleasing (index);
+
+            if (releasing != bank.isVoiceReleasing (bestIndex))
+            {
+                if (releasing)
+                {
+                    best = voice;
+                    bestIndex = index;
+                }
+
+                continue;
+            }
+
+            const float loudnessDifference = loudness (index) - loudness (bestIndex);
+
+            if (loudnessDifference < 0.0f || (loudnessDifference == 0.0f && older))
+            {
+                best = voice;
+                bestIndex = index;
+            }
+        }
+        else if (older)
+        {
+            best = voice;
+            bestIndex = index;
+        }
+    }
+
+    if (best != nullptr)
+        log->post (RealtimeLog::Event::voiceStolen, midiNoteNumber, bestIndex);
+    else
+        log->post (RealtimeLog::Event::noteDropped, midiNoteNumber);
+
+    return best;
+}
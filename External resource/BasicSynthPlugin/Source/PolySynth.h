@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    PolySynth.h
+    Created: 17 Oct 2026 10:40:51am
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "VoiceBank.h"
+#include "VoiceRenderPool.h"
+#include "RealtimeLog.h"
+
+//==============================================================================
+/**
+    Synthesiser whose voices all live in one VoiceBank.
+
+    The JUCE Synthesiser still does the MIDI handling and voice allocation, but
+    renderVoices() renders the whole bank in one pass instead of asking each
+    voice to render itself.
+*/
+class PolySynth : public Synthesiser
+{
+public:
+    enum StealMode
+    {
+        stealQuietest = 0,  // releasing notes first, then the lowest envelope level, oldest on a tie
+        stealOldest         // earliest started note
+    };
+
+    // Either way a voice started since the last render is never stolen, it hasn't played yet and
+    // its level is still 0. A note that finds nothing else to steal is dropped instead, so a chord
+    // bigger than the polyphony keeps its first notes rather than only its last.
+
+    PolySynth();
+
+    /** Limits how many voices can play at once (1 to VoiceBank::maxVoices).
+        All VoiceBank::maxVoices voices always exist, the ones above the limit just
+        refuse new notes, so this doesn't allocate and must be called from the audio
+        thread (or before playback starts).
+    */
+    void setPolyphony (int numVoices);
+    int getPolyphony() const noexcept                   { return bank.getNumVoices(); }
+
+    void setStealMode (StealMode newMode) noexcept      { stealMode = newMode; }
+    StealMode getStealMode() const noexcept             { return stealMode; }
+
+    /** Renders the voices on this many extra threads, 0 renders them all on the
+        audio thread. Starts and stops threads, so don't call it from processBlock,
+        but it only holds the lock while it swaps them in, so it won't hold up rendering.
+    */
+    void setNumRenderThreads (int numThreads);
+    int getNumRenderThreads() const noexcept            { return renderPool.getNumThreads(); }
+
+    VoiceBank& getVoiceBank() noexcept                  { return bank; }
+
+    /** Sets how voices are placed in a multichannel output, SpatialEncoder::none for mono/stereo. */
+    void setSpatialLayout (SpatialEncoder::Layout layout)   { bank.setSpatialLayout (layout); }
+
+    /** True if any voice is playing or still in its release tail. */
+    bool isSounding() const noexcept                    { return bank.getNumActiveVoices() > 0; }
+
+    void setCurrentPlaybackSampleRate (double sampleRate) override;
+
+    // MIDI controllers that position notes on multichannel outputs
+    static constexpr int azimuthController = 10;    // pan: 0 behind via the left, 32 left, 64 front, 96 right
+    static constexpr int elevationController = 16;  // general purpose 1: 0 below, 64 level, 127 above
+
+    void handleController (int midiChannel, int controllerNumber, int controllerValue) override;
+
+protected:
+    void renderVoices (AudioBuffer<float>& outputAudio, int startSample, int numSamples) override;
+    SynthesiserVoice* findVoiceToSteal (SynthesiserSound* soundToPlay, int midiChannel, int midiNoteNumber) const override;
+
+private:
+    VoiceBank bank;
+    VoiceRenderPool renderPool { bank };
+    SharedResourcePointer<RealtimeLog> log;
+    StealMode stealMode = stealQuietest;
+    uint32 firstUnrenderedStart = 0;    // the bank's start order when renderVoices last ran
+    float channelAzimuth[16] = {}, channelElevation[16] = {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PolySynth)
+};
@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    PresetBank.cpp
+    Created: 17 Oct 2026 4:58:40pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "PresetBank.h"
+#include "VoiceBank.h"
+
+//==============================================================================
+PresetBank::PresetBank (LoadedCallback callbackForLoadedPresets)
+    : onLoaded (std::move (callbackForLoadedPresets))
+{
+    addFactoryPresets();
+}
+
+PresetBank::~PresetBank()
+{
+    stopLoading();
+}
+
+void PresetBank::stopLoading()
+{
+    loader.removeAllJobs (true, 2000);
+}
+
+void PresetBank::addFactoryPresets()
+{
+    auto makePreset = [this] (const char* name, float level, int polyphony, int stealMode,
+                              float attackSeconds, float releaseSeconds, int voiceType, int fmPatch)
+    {
+        SynthState state;
+        state.level = level;
+        state.polyphony = polyphony;
+        state.stealMode = stealMode;
+        state.attackSeconds = attackSeconds;
+        state.releaseSeconds = releaseSeconds;
+        state.voiceType = voiceType;
+        state.fmPatch = fmPatch;
+        add (name, state);
+    };
+
+    makePreset ("Default",    0.5f,  32,  0, 0.005f, 0.1f,  VoiceBank::sineVoice, 0);
+    makePreset ("Pluck",      0.6f,  16,  1, 0.001f, 0.05f, VoiceBank::sineVoice, 0);
+    makePreset ("Pad",        0.35f, 64,  0, 0.4f,   1.5f,  VoiceBank::sineVoice, 0);
+    makePreset ("Drone",      0.25f, 128, 1, 1.5f,   4.0f,  VoiceBank::sineVoice, 0);
+    makePreset ("FM Piano",   0.5f,  32,  0, 0.001f, 0.5f,  VoiceBank::fmVoice,   0);
+    makePreset ("FM Bell",    0.4f,  32,  1, 0.001f, 3.0f,  VoiceBank::fmVoice,   1);
+    makePreset ("FM Brass",   0.4f,  16,  0, 0.02f,  0.2f,  VoiceBank::fmVoice,   2);
+    makePreset ("FM Bass",    0.6f,  8,   1, 0.001f, 0.1f,  VoiceBank::fmVoice,   3);
+}
+
+//==============================================================================
+int PresetBank::getNumPresets() const
+{
+    const ScopedLock sl (presetLock);
+    return presets.size();
+}
+
+String PresetBank::getName (int index) const
+{
+    const ScopedLock sl (presetLock);
+
+    if (auto* preset = presets[index])
+        return preset->name;
+
+    return {};
+}
+
+int PresetBank::add (const String& name, const SynthState& state)
+{
+    auto* preset = new Preset();
+    preset->name = name;
+
+    // one lock for both, so two presets added at once can't claim the same index
+    const ScopedLock sl (presetLock);
+
+    SynthState copy (state);
+    copy.program = presets.size();
+    copy.writeTo (preset->data);
+
+    presets.add (preset);
+    return copy.program;
+}
+
+void PresetBank::load (int index)
+{
+    loader.addJob ([this, index]
+    {
+        MemoryBlock data;
+
+        {
+            const ScopedLock sl (presetLock);
+
+            if (auto* preset = presets[index])
+                data = preset->data;
+            else
+                return;
+        }
+
+        auto state = std::make_unique<SynthState>();
+
+        if (SynthState::readFrom (data.getData(), (int) data.getSize(), *state))
+        {
+            state->program = index;
+            onLoaded (std::move (state));
+        }
+    });
+}
@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    PresetBank.h
+    Created: 17 Oct 2026 4:58:40pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "SynthState.h"
+
+//==============================================================================
+/**
+    A list of named presets stored as SynthState binary data.
+
+    load() decodes and checks a preset on a background thread and hands the
+    finished SynthState to the callback from that thread, so switching sounds
+    never does any of that work on the audio or message thread.
+*/
+class PresetBank
+{
+public:
+    using LoadedCallback = std::function<void (std::unique_ptr<SynthState>)>;
+
+    /** Starts with the factory presets. */
+    explicit PresetBank (LoadedCallback callbackForLoadedPresets);
+    ~PresetBank();
+
+    int getNumPresets() const;
+    String getName (int index) const;
+
+    /** Adds a preset, returns its index. */
+    int add (const String& name, const SynthState& state);
+
+    /** Starts loading a preset in the background and returns straight away. */
+    void load (int index);
+
+    /** Cancels queued loads and waits for one in progress to finish. */
+    void stopLoading();
+
+private:
+    struct Preset
+    {
+        String name;
+        MemoryBlock data;
+    };
+
+    void addFactoryPresets();
+
+    LoadedCallback onLoaded;
+
+    CriticalSection presetLock;
+    OwnedArray<Preset> presets;
+
+    ThreadPool loader { 1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PresetBank)
+};
@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+    RealtimeLog.cpp
+    Created: 17 Oct 2026 3:02:15pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "RealtimeLog.h"
+
+static_assert ((RealtimeLog::capacity & (RealtimeLog::capacity - 1)) == 0, "capacity must be a power of two");
+
+//==============================================================================
+RealtimeLog::RealtimeLog()
+    : startTicks (Time::getHighResolutionTicks())
+{
+    // slot i is free for the writer that claims position i
+    for (uint32 i = 0; i < (uint32) capacity; ++i)
+        slots[i].sequence.store (i, std::memory_order_relaxed);
+
+    drainer.startThread (2);
+}
+
+RealtimeLog::~RealtimeLog()
+{
+    drainer.stopThread (1000);
+    drain();
+}
+
+//==============================================================================
+bool RealtimeLog::post (Event type, int a, int b, float value) noexcept
+{
+    // bounded multi-producer queue: a writer claims a position by bumping writePosition,
+    // and each slot's sequence says whether it has been read since it was last written
+    uint32 position = writePosition.load (std::memory_order_relaxed);
+    Slot* slot;
+
+    for (;;)
+    {
+        slot = &slots[position & (capacity - 1)];
+        const auto difference = (int32) (slot->sequence.load (std::memory_order_acquire) - position);
+
+        if (difference == 0)
+        {
+            if (writePosition.compare_exchange_weak (position, position + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+        {
+            numDropped.fetch_add (1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            position = writePosition.load (std::memory_order_relaxed);
+        }
+    }
+
+    slot->record = { Time::getHighResolutionTicks(), (int32) a, (int32) b, value, type };
+    slot->sequence.store (position + 1, std::memory_order_release);
+    return true;
+}
+
+bool RealtimeLog::pop (Record& record) noexcept
+{
+    Slot& slot = slots[readPosition & (capacity - 1)];
+
+    if ((int32) (slot.sequence.load (std::memory_order_acquire) - (readPosition + 1)) < 0)
+        return false;
+
+    record = slot.record;
+    slot.sequence.store (readPosition + capacity, std::memory_order_release);
+    ++readPosition;
+    return true;
+}
+
+//==============================================================================
+String RealtimeLog::format (const Record& record) const
+{
+    const double ms = Time::highResolutionTicksToSeconds (record.ticks - startTicks) * 1000.0;
+    String text ("[" + String (ms, 1) + "ms] ");
+
+    switch (record.type)
+    {
+        case Event::noteOn:
+            return text + "note on " + String (record.a) + " velocity " + String (record.value, 2) + " voice " + String (record.b);
+
+        case Event::noteOff:
+            return text + "note off " + String (record.a) + " voice " + String (record.b);
+
+        case Event::voiceStolen:
+            return text + "voice " + String (record.b) + " stolen for note " + String (record.a);
+
+        case Event::noteDropped:
+            return text + "note " + String (record.a) + " dropped, no voice to steal";
+
+        case Event::overload:
+            return text + "overload, processBlock took " + String (record.a) + "us of a " + String (record.b) + "us block";
+
+        default:
+            jassertfalse;
+            return text + "unknown event";
+    }
+}
+
+void RealtimeLog::drain()
+{
+    Record record;
+
+    while (pop (record))
+        Logger::writeToLog (format (record));
+
+    const uint32 dropped = getNumDropped();
+
+    if (dropped != numDroppedReported)
+    {
+        Logger::writeToLog ("RealtimeLog: " + String (dropped - numDroppedReported) + " records dropped");
+        numDroppedReported = dropped;
+    }
+}
+
+//==============================================================================
+RealtimeLog::Drainer::Drainer (RealtimeLog& owner)
+    : Thread ("RealtimeLog"), log (owner)
+{
+}
+
+void RealtimeLog::Drainer::run()
+{
+    while (! threadShouldExit())
+    {
+        log.drain();
+        wait (100);
+    }
+}
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    RealtimeLog.h
+    Created: 17 Oct 2026 3:02:15pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Debug log that's safe to write to from the audio thread.
+
+    post() copies a small fixed-size record into a preallocated lock-free
+    ring, it never allocates, locks or formats text. A background thread
+    drains the ring a few times a second, turns the records into strings and
+    hands them to Logger::writeToLog().
+
+    There's one log per process, shared by every plugin instance through
+    SharedResourcePointer<RealtimeLog>, and any number of threads can post to
+    it at once. If the ring is full the record is dropped and counted.
+*/
+class RealtimeLog
+{
+public:
+    enum class Event : uint8
+    {
+        noteOn,         // a = note, b = voice, value = velocity
+        noteOff,        // a = note, b = voice, value = velocity
+        voiceStolen,    // a = new note, b = voice
+        noteDropped,    // a = note, every voice it could steal started in the same block
+        overload        // a = microseconds processBlock took, b = microseconds the block lasts
+    };
+
+    static constexpr int capacity = 1024;   // must be a power of two
+
+    RealtimeLog();
+    ~RealtimeLog();
+
+    /** Queues an event, returns false if the ring was full and it had to be dropped. */
+    bool post (Event type, int a = 0, int b = 0, float value = 0.0f) noexcept;
+
+    /** Total number of records that didn't fit in the ring. */
+    uint32 getNumDropped() const noexcept       { return numDropped.load (std::memory_order_relaxed); }
+
+private:
+    //==============================================================================
+    struct Record
+    {
+        int64 ticks;
+        int32 a, b;
+        float value;
+        Event type;
+    };
+
+    struct Slot
+    {
+        std::atomic<uint32> sequence;
+        Record record;
+    };
+
+    class Drainer : public Thread
+    {
+    public:
+        explicit Drainer (RealtimeLog& owner);
+        void run() override;
+
+    private:
+        RealtimeLog& log;
+    };
+
+    bool pop (Record& record) noexcept;
+    String format (const Record& record) const;
+    void drain();
+
+    Slot slots[capacity];
+    std::atomic<uint32> writePosition { 0 };
+    uint32 readPosition = 0;   // only touched by the drain thread
+    std::atomic<uint32> numDropped { 0 };
+    uint32 numDroppedReported = 0;
+
+    const int64 startTicks;
+    Drainer drainer { *this };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RealtimeLog)
+};
@@ -0,0 +1,139 @@
+/*
+  ==============================================================================
+
+    SpatialEncoder.cpp
+    Created: 18 Oct 2026 9:20:06am
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "SpatialEncoder.h"
+
+//==============================================================================
+bool SpatialEncoder::getLayoutFor (const AudioChannelSet& channels, Layout& layout)
+{
+    if (channels == AudioChannelSet::mono() || channels == AudioChannelSet::stereo())
+        layout = none;
+    else if (channels == AudioChannelSet::quadraphonic())
+        layout = quad;
+    else if (channels == AudioChannelSet::create5point1())
+        layout = fivePointOne;
+    else if (channels == AudioChannelSet::ambisonic (1))
+        layout = ambisonicFirstOrder;
+    else if (channels == AudioChannelSet::ambisonic (2))
+        layout = ambisonicSecondOrder;
+    else if (channels == AudioChannelSet::ambisonic (3))
+        layout = ambisonicThirdOrder;
+    else
+        return false;
+
+    return true;
+}
+
+int SpatialEncoder::getNumChannels (Layout layout) noexcept
+{
+    switch (layout)
+    {
+        case quad:                  return 4;
+        case fivePointOne:          return 6;
+        case ambisonicFirstOrder:   return 4;
+        case ambisonicSecondOrder:  return 9;
+        case ambisonicThirdOrder:   return 16;
+        case none:
+        default:                    return 0;
+    }
+}
+
+//==============================================================================
+void SpatialEncoder::computeGains (Layout layout, float azimuth, float elevation, float* gains) noexcept
+{
+    // channel orders follow AudioChannelSet: quadraphonic is L R Ls Rs, 5.1 is L R C LFE Ls Rs
+    static const Speaker quadRing[] = { { 3, -2.3562f }, { 1, -0.7854f }, { 0, 0.7854f }, { 2, 2.3562f } };
+    static const Speaker surroundRing[] = { { 5, -1.9199f }, { 1, -0.5236f }, { 2, 0.0f }, { 0, 0.5236f }, { 4, 1.9199f } };
+
+    switch (layout)
+    {
+        case quad:
+            panAroundRing (quadRing, numElementsInArray (quadRing), azimuth, gains);
+            break;
+
+        case fivePointOne:
+            panAroundRing (surroundRing, numElementsInArray (surroundRing), azimuth, gains);
+            gains[3] = 0.0f;   // nothing goes to the LFE
+            break;
+
+        case ambisonicFirstOrder:   encodeAmbisonic (1, azimuth, elevation, gains); break;
+        case ambisonicSecondOrder:  encodeAmbisonic (2, azimuth, elevation, gains); break;
+        case ambisonicThirdOrder:   encodeAmbisonic (3, azimuth, elevation, gains); break;
+
+        case none:
+        default:
+            jassertfalse;
+            break;
+    }
+}
+
+void SpatialEncoder::panAroundRing (const Speaker* speakers, int numSpeakers, float azimuth, float* gains) noexcept
+{
+    // speakers are sorted by azimuth, find the pair either side of the source
+    azimuth = std::remainder (azimuth, MathConstants<float>::twoPi);
+
+    int next = 0;
+
+    while (next < numSpeakers && speakers[next].azimuth < azimuth)
+        ++next;
+
+    const auto& a = speakers[(next + numSpeakers - 1) % numSpeakers];
+    const auto& b = speakers[next % numSpeakers];
+
+    float span = b.azimuth - a.azimuth;
+    float offset = azimuth - a.azimuth;
+
+    // the pair that wraps round behind the listener
+    if (span <= 0.0f)   span += MathConstants<float>::twoPi;
+    if (offset < 0.0f)  offset += MathConstants<float>::twoPi;
+
+    const float x = jlimit (0.0f, 1.0f, offset / span);
+
+    for (int i = 0; i < numSpeakers; ++i)
+        gains[speakers[i].channel] = 0.0f;
+
+    gains[a.channel] = std::sqrt (1.0f - x);
+    gains[b.channel] = std::sqrt (x);
+}
+
+void SpatialEncoder::encodeAmbisonic (int order, float azimuth, float elevation, float* gains) noexcept
+{
+    const float x = std::cos (elevation) * std::cos (azimuth);
+    const float y = std::cos (elevation) * std::sin (azimuth);
+    const float z = std::sin (elevation);
+
+    // real spherical harmonics, ACN order, SN3D
+    gains[0] = 1.0f;
+    gains[1] = y;
+    gains[2] = z;
+    gains[3] = x;
+
+    if (order < 2)
+        return;
+
+    const float root3 = 1.7320508f;
+    gains[4] = root3 * x * y;
+    gains[5] = root3 * y * z;
+    gains[6] = 0.5f * (3.0f * z * z - 1.0f);
+    gains[7] = root3 * x * z;
+    gains[8] = 0.5f * root3 * (x * x - y * y);
+
+    if (order < 3)
+        return;
+
+    const float root5over8 = 0.7905694f, root15 = 3.8729833f, root3over8 = 0.6123724f;
+    gains[9]  = root5over8 * y * (3.0f * x * x - y * y);
+    gains[10] = root15 * x * y * z;
+    gains[11] = root3over8 * y * (5.0f * z * z - 1.0f);
+    gains[12] = 0.5f * z * (5.0f * z * z - 3.0f);
+    gains[13] = root3over8 * x * (5.0f * z * z - 1.0f);
+    gains[14] = 0.5f * root15 * z * (x * x - y * y);
+    gains[15] = root5over8 * x * (x * x - 3.0f * y * y);
+}
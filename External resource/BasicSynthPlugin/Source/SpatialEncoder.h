@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    SpatialEncoder.h
+    Created: 18 Oct 2026 9:20:06am
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Per voice output gains for the multichannel layouts.
+
+    Speaker rings (quad, 5.1) use equal power panning between the two nearest
+    speakers, the same sqrt(x) / sqrt(1 - x) law as maxiMix::stereo and
+    maxiMix::ambisonic. Ambisonic layouts are encoded as AmbiX: ACN channel
+    order with SN3D normalisation, which is what AudioChannelSet::ambisonic()
+    and Unity's ambisonic decoders expect.
+
+    Angles are in radians, azimuth 0 is straight ahead and positive turns to
+    the left, elevation is positive upwards.
+*/
+class SpatialEncoder
+{
+public:
+    enum Layout
+    {
+        none = 0,               // mono and stereo: every voice goes to every channel unchanged
+        quad,
+        fivePointOne,
+        ambisonicFirstOrder,
+        ambisonicSecondOrder,
+        ambisonicThirdOrder
+    };
+
+    static constexpr int maxChannels = 16;  // third order ambisonics
+
+    /** Returns false if the channel set isn't one the synth can output. */
+    static bool getLayoutFor (const AudioChannelSet& channels, Layout& layout);
+
+    static int getNumChannels (Layout layout) noexcept;
+
+    /** Writes getNumChannels (layout) gains for a source in the given direction. */
+    static void computeGains (Layout layout, float azimuth, float elevation, float* gains) noexcept;
+
+private:
+    struct Speaker
+    {
+        int channel;
+        float azimuth;
+    };
+
+    static void panAroundRing (const Speaker* speakers, int numSpeakers, float azimuth, float* gains) noexcept;
+    static void encodeAmbisonic (int order, float azimuth, float elevation, float* gains) noexcept;
+};
@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    SynthState.cpp
+    Created: 17 Oct 2026 4:30:12pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "SynthState.h"
+#include "VoiceBank.h"
+
+//==============================================================================
+void SynthState::writeTo (MemoryBlock& destData) const
+{
+    MemoryOutputStream payload;
+    payload.writeFloat (level);
+    payload.writeShort ((short) polyphony);
+    payload.writeByte ((char) stealMode);
+    payload.writeFloat (attackSeconds);
+    payload.writeFloat (releaseSeconds);
+    payload.writeShort ((short) program);
+    payload.writeByte ((char) voiceType);
+    payload.writeByte ((char) fmPatch);
+
+    MemoryOutputStream out (destData, true);
+    out.writeInt ((int) magic);
+    out.writeShort ((short) currentVersion);
+    out.writeShort ((short) payload.getDataSize());
+    out.write (payload.getData(), payload.getDataSize());
+}
+
+bool SynthState::readFrom (const void* data, int sizeInBytes, SynthState& state)
+{
+    const int headerSize = 8;
+
+    if (data == nullptr || sizeInBytes < headerSize)
+        return false;
+
+    MemoryInputStream in (data, (size_t) sizeInBytes, false);
+
+    if ((uint32) in.readInt() != magic)
+        return false;
+
+    const auto version = (uint16) in.readShort();
+    const auto payloadSize = (int) (uint16) in.readShort();
+
+    if (version == 0 || payloadSize > sizeInBytes - headerSize)
+        return false;
+
+    // only read as far as the payload goes, anything it doesn't cover keeps its default
+    SynthState result;
+    const int64 end = headerSize + payloadSize;
+    auto has = [&in, end] (int numBytes) { return in.getPosition() + numBytes <= end; };
+
+    if (has (4))  result.level          = in.readFloat();
+    if (has (2))  result.polyphony      = in.readShort();
+    if (has (1))  result.stealMode      = in.readByte();
+    if (has (4))  result.attackSeconds  = in.readFloat();
+    if (has (4))  result.releaseSeconds = in.readFloat();
+    if (has (2))  result.program        = in.readShort();
+    if (has (1))  result.voiceType      = in.readByte();
+    if (has (1))  result.fmPatch        = in.readByte();
+
+    result.sanitise();
+    state = result;
+    return true;
+}
+
+void SynthState::sanitise() noexcept
+{
+    // NaNs fail every comparison, so they end up at the lower limit
+    auto clampFloat = [] (float value, float low, float high) { return value >= low ? jmin (value, high) : low; };
+
+    level = clampFloat (level, 0.0f, 1.0f);
+    polyphony = jlimit (1, (int) VoiceBank::maxVoices, polyphony);
+    stealMode = jlimit (0, 1, stealMode);
+    attackSeconds = clampFloat (attackSeconds, 0.0005f, 10.0f);
+    releaseSeconds = clampFloat (releaseSeconds, 0.001f, 30.0f);
+    program = jmax (0, program);
+    voiceType = jlimit (0, 1, voiceType);
+    fmPatch = jlimit (0, FMEngine::numFactoryPatches - 1, fmPatch);
+}
+
+void SynthState::compileFMPatch (double sampleRate)
+{
+    compiledFMPatch = FMEngine::CompiledPatch (FMEngine::getFactoryPatch (fmPatch), sampleRate > 0.0 ? sampleRate : 44100.0);
+}
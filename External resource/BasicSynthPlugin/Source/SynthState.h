@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    SynthState.h
+    Created: 17 Oct 2026 4:30:12pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "FMEngine.h"
+
+//==============================================================================
+/**
+    Everything that makes up a BasicSynth sound: the parameter values and the
+    voice configuration. This is what getStateInformation() saves and what a
+    preset holds.
+
+    The binary form is a small little-endian header (magic, version, payload
+    size) followed by the fields in the order they were added. Newer versions
+    only ever append fields, so an old build reads the fields it knows and
+    skips the rest, and a new build gives fields missing from old data their
+    default values.
+*/
+struct SynthState
+{
+    static constexpr uint32 magic = 0x74536242;     // "BbSt"
+    static constexpr uint16 currentVersion = 2;
+
+    // version 1
+    float level = 0.5f;
+    int polyphony = 32;
+    int stealMode = 0;              // PolySynth::StealMode
+    float attackSeconds = 0.005f;
+    float releaseSeconds = 0.1f;
+    int program = 0;
+
+    // version 2
+    int voiceType = 0;              // VoiceBank::VoiceType
+    int fmPatch = 0;                // FMEngine factory patch
+
+    // not saved: fmPatch worked out for the sample rate by compileFMPatch(), so the audio
+    // thread only has to copy it in
+    FMEngine::CompiledPatch compiledFMPatch;
+
+    /** Appends the binary form to the block. */
+    void writeTo (MemoryBlock& destData) const;
+
+    /** Fills state from data written by writeTo(), returns false if the data isn't valid. */
+    static bool readFrom (const void* data, int sizeInBytes, SynthState& state);
+
+    /** Clamps every field into its valid range. */
+    void sanitise() noexcept;
+
+    /** Fills compiledFMPatch from fmPatch, at 44.1kHz if the rate isn't known yet. Calls exp(),
+        so not on the audio thread.
+    */
+    void compileFMPatch (double sampleRate);
+};
@@ -11,35 +11,78 @@
 #pragma once
 #include <JuceHeader.h>
 #include "SynthSound.h"
-#include "Maximilian.h"
+#include "VoiceBank.h"
+#include "RealtimeLog.h"
 
+// A voice is only a handle onto its slot in the VoiceBank, the JUCE Synthesiser uses it for
+// note allocation while PolySynth renders the whole bank at once.
 class SynthVoice : public SynthesiserVoice
 {
 
 public:
 
-    SynthVoice()
+    SynthVoice(VoiceBank& bankToUse, int indexInBank, RealtimeLog& logToUse)
+        : bank(bankToUse), bankIndex(indexInBank), log(logToUse)
     {
     };
 
+    int getBankIndex() const
+    {
+        return bankIndex;
+    }
+
+    //the channel of the current note, the Synthesiser sets it before calling startNote
+    int getMidiChannel() const
+    {
+        for (int channel = 1; channel <= 16; ++channel)
+            if (isPlayingChannel(channel))
+                return channel;
+
+        return 1;
+    }
+
     bool canPlaySound (SynthesiserSound* sound)
     {
-        return dynamic_cast<SynthSound*>(sound) != nullptr;
+        //voices above the current polyphony limit are never given notes
+        return bankIndex < bank.getNumVoices() && dynamic_cast<SynthSound*>(sound) != nullptr;
     }
 
     void startNote (int midiNoteNumber, float velocity, SynthesiserSound* sound, int currentPitchWheelPosition)
     {
-        *frequency = MidiMessage::getMidiNoteInHertz(midiNoteNumber);
+        bank.startVoice(bankIndex, MidiMessage::getMidiNoteInHertz(midiNoteNumber), velocity, getMidiChannel());
         //frequency = frequencyOfA * std::pow(2.0, (midiNoteNumber - 69) / 12.0);
         //std::cout << midiNoteNumber << std::endl;
-        Logger::outputDebugString(std::to_string(midiNoteNumber));
+        log.post(RealtimeLog::Event::noteOn, midiNoteNumber, bankIndex, velocity);
     }
 
     void stopNote(float velocity, bool allowTailOff)
     {
+        log.post(RealtimeLog::Event::noteOff, getCurrentlyPlayingNote(), bankIndex, velocity);
+
+        if (allowTailOff)
+        {
+            //the bank fades the voice out, updateTail() frees it once it's silent
+            bank.releaseVoice(bankIndex);
+            return;
+        }
+
+        bank.stopVoice(bankIndex);
         clearCurrentNote();
     }
 
+    //called by PolySynth after each render, frees the voice once its release tail has died away
+    void updateTail()
+    {
+        if (isVoiceActive() && ! bank.isVoiceActive(bankIndex))
+            clearCurrentNote();
+    }
+
+    //true while the voice is still making sound, including its release tail
+    bool isSounding() const
+    {
+        return bank.isVoiceActive(bankIndex);
+    }
+
     void pitchWheelMoved(int newPitchWheel)
     {
     }
@@ -51,24 +94,13 @@ public:
     void renderNextBlock(AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
     {
         //DSP CODE
-        for (int sample = 0; sample < numSamples; ++sample)
-        {
-            
-            double theWave = osc1.sinewave(frequencyOfA);
-
-            for (int channel = 0; channel < outputBuffer.getNumChannels(); ++channel)
-            {
-                outputBuffer.addSample(channel, startSample, theWave);
-            }
-            ++startSample;
-        }
+        //nothing to do here, PolySynth::renderVoices renders every voice in the bank in one pass
     }
 
 
 private:
-    AudioParameterFloat* frequency;
-    const double frequencyOfA = 440;
+    VoiceBank& bank;
+    const int bankIndex;
+    RealtimeLog& log;
 
-    maxiOsc osc1;
-    
 };
\ No newline at end of file
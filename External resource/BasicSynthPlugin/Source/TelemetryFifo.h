@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    TelemetryFifo.h
+    Created: 17 Oct 2026 3:47:33pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/** What processBlock measured about one block, or several merged together. */
+struct TelemetryFrame
+{
+    static constexpr int maxChannels = 16;
+
+    int numChannels = 0;
+    int numBlocks = 1;
+    int numSamples = 0;
+    float peak[maxChannels] = {};
+    float rms[maxChannels] = {};
+    int numActiveVoices = 0;
+    uint32 processNanoseconds = 0;  // all the blocks together
+    uint32 worstNanoseconds = 0;    // the slowest single block
+    uint32 numXruns = 0;    // blocks since prepareToPlay that took longer to render than they last
+
+    /** Adds a later frame in: peaks are the loudest, rms and times cover both, and the rest is the later one's. */
+    void merge (const TelemetryFrame& later) noexcept
+    {
+        const int total = jmax (1, numSamples + later.numSamples);
+
+        for (int channel = 0; channel < later.numChannels; ++channel)
+        {
+            if (channel >= numChannels)
+            {
+                peak[channel] = later.peak[channel];
+                rms[channel] = later.rms[channel];
+                continue;
+            }
+
+            peak[channel] = jmax (peak[channel], later.peak[channel]);
+            rms[channel] = std::sqrt ((rms[channel] * rms[channel] * (float) numSamples
+                                         + later.rms[channel] * later.rms[channel] * (float) later.numSamples) / (float) total);
+        }
+
+        // saturate rather than wrap if nothing has been read for a long while
+        const auto limit = (uint64) std::numeric_limits<uint32>::max();
+        processNanoseconds = (uint32) jmin ((uint64) processNanoseconds + later.processNanoseconds, limit);
+        worstNanoseconds = jmax (worstNanoseconds, later.worstNanoseconds);
+        numBlocks = (int) jmin ((int64) numBlocks + later.numBlocks, (int64) std::numeric_limits<int>::max());
+        numSamples = (int) jmin ((int64) numSamples + later.numSamples, (int64) std::numeric_limits<int>::max());
+        numChannels = later.numChannels;
+        numActiveVoices = later.numActiveVoices;
+        numXruns = later.numXruns;
+    }
+};
+
+//==============================================================================
+/**
+    Wait-free single producer, single consumer queue of TelemetryFrames, written by
+    processBlock and read by the editor. Frames are copied in and out of a
+    preallocated array so neither side ever allocates or locks. If the editor is
+    closed or falls behind, for example with very small blocks, frames that don't
+    fit are merged into one held back on the audio thread, which goes in as soon
+    as there's room. So the load and xrun figures still cover every block.
+*/
+class TelemetryFifo
+{
+public:
+    static constexpr int capacity = 64;
+
+    /** Audio thread only. Returns false if the queue was full and the frame was held back. */
+    bool push (const TelemetryFrame& frame) noexcept
+    {
+        if (hasOverflow)
+            overflow.merge (frame);
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+        if (size1 + size2 == 0)
+        {
+            if (! hasOverflow)
+            {
+                overflow = frame;
+                hasOverflow = true;
+            }
+
+            return false;
+        }
+
+        frames[size1 > 0 ? start1 : start2] = hasOverflow ? overflow : frame;
+        fifo.finishedWrite (1);
+        hasOverflow = false;
+        return true;
+    }
+
+    /** Reading thread only. Returns false if there's nothing waiting. */
+    bool pop (TelemetryFrame& frame) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (1, start1, size1, start2, size2);
+
+        if (size1 + size2 == 0)
+            return false;
+
+        frame = frames[size1 > 0 ? start1 : start2];
+        fifo.finishedRead (1);
+        return true;
+    }
+
+private:
+    AbstractFifo fifo { capacity };
+    TelemetryFrame frames[capacity];
+
+    TelemetryFrame overflow;    // audio thread only
+    bool hasOverflow = false;
+};
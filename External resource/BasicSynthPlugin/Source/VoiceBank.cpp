@@ -0,0 +1,384 @@
+/*
+  ==============================================================================
+
+    VoiceBank.cpp
+    Created: 17 Oct 2026 10:12:04am
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "VoiceBank.h"
+#include "../Maximilian/maximilian.h"
+
+static_assert (FMEngine::maxVoices == VoiceBank::maxVoices && FMEngine::laneWidth == VoiceBank::laneWidth,
+               "FMEngine lays its voices out the same way as the bank");
+
+//==============================================================================
+VoiceBank::VoiceBank()
+{
+    std::fill (phase, phase + maxVoices, 0u);
+    std::fill (increment, increment + maxVoices, 0u);
+    std::fill (level, level + maxVoices, 0.0f);
+    std::fill (target, target + maxVoices, 0.0f);
+    std::fill (velocity, velocity + maxVoices, 0.0f);
+    std::fill (rate, rate + maxVoices, 0.0f);
+    std::fill (startOrder, startOrder + maxVoices, 0u);
+    std::fill (active, active + maxVoices, (uint8) 0);
+    std::fill (releasing, releasing + maxVoices, (uint8) 0);
+    std::fill (activeInGroup, activeInGroup + maxGroups, 0);
+    std::fill (azimuth, azimuth + maxVoices, 0.0f);
+    std::fill (elevation, elevation + maxVoices, 0.0f);
+    std::fill (channelAzimuth, channelAzimuth + 16, 0.0f);
+    std::fill (channelElevation, channelElevation + 16, 0.0f);
+    std::fill (gainsDirty, gainsDirty + maxVoices, (uint8) 1);
+    std::fill (gains, gains + maxVoices * gainStride, 0.0f);
+
+    updateCoefficients();
+}
+
+void VoiceBank::setSampleRate (double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    updateCoefficients();
+    fm.setSampleRate (newSampleRate);
+}
+
+void VoiceBank::setEnvelope (float newAttackSeconds, float newReleaseSeconds)
+{
+    attackSeconds = newAttackSeconds;
+    releaseSeconds = newReleaseSeconds;
+    updateCoefficients();
+}
+
+void VoiceBank::updateCoefficients()
+{
+    // one pole segments, the default 100ms release takes around 0.9s from full level to silenceThreshold
+    attackCoefficient  = (float) (1.0 - std::exp (-1.0 / (attackSeconds * sampleRate)));
+    releaseCoefficient = (float) (1.0 - std::exp (-1.0 / (releaseSeconds * sampleRate)));
+}
+
+void VoiceBank::setNumVoices (int newNumVoices)
+{
+    jassert (newNumVoices > 0 && newNumVoices <= maxVoices);
+    newNumVoices = jlimit (1, maxVoices, newNumVoices);
+
+    // voices above the new count are silenced
+    for (int i = newNumVoices; i < numVoices; ++i)
+        stopVoice (i);
+
+    numVoices = newNumVoices;
+}
+
+//==============================================================================
+void VoiceBank::startVoice (int index, double frequency, float newVelocity, int midiChannel)
+{
+    jassert (isPositiveAndBelow (index, numVoices));
+
+    fm.startVoice (index, frequency);
+
+    if (! active[index])
+    {
+        active[index] = 1;
+        ++activeInGroup[index / laneWidth];
+        ++numActive;
+        level[index] = 0.0f;
+        phase[index] = 0;
+    }
+
+    increment[index] = maxiFixedPointOsc::phaseIncrement (frequency, sampleRate);
+    target[index] = newVelocity;
+    velocity[index] = newVelocity;
+    rate[index] = attackCoefficient;
+    releasing[index] = 0;
+    startOrder[index] = nextStartOrder++;
+
+    const int channelIndex = jlimit (1, 16, midiChannel) - 1;
+    setVoicePosition (index, channelAzimuth[channelIndex], channelElevation[channelIndex]);
+}
+
+void VoiceBank::releaseVoice (int index)
+{
+    if (! active[index])
+        return;
+
+    target[index] = 0.0f;
+    rate[index] = releaseCoefficient;
+    releasing[index] = 1;
+    fm.releaseVoice (index);
+}
+
+double VoiceBank::getTailSeconds() const noexcept
+{
+    // the releases are one pole decays, the bank's or the slowest heard operator's
+    const double timeConstant = voiceType == fmVoice ? fm.getReleaseSeconds() : releaseSeconds;
+    return timeConstant * std::log (1.0 / silenceThreshold);
+}
+
+int VoiceBank::retireSilentVoices() noexcept
+{
+    int numRetired = 0;
+
+    for (int i = 0; i < numVoices; ++i)
+    {
+        const bool silent = voiceType == fmVoice ? fm.isVoiceSilent (i, silenceThreshold)
+                                                 : level[i] < silenceThreshold;
+
+        if (releasing[i] && silent)
+        {
+            stopVoice (i);
+            ++numRetired;
+        }
+    }
+
+    return numRetired;
+}
+
+void VoiceBank::stopVoice (int index)
+{
+    if (! active[index])
+        return;
+
+    active[index] = 0;
+    releasing[index] = 0;
+    --activeInGroup[index / laneWidth];
+    --numActive;
+    level[index] = 0.0f;
+    target[index] = 0.0f;
+}
+
+//==============================================================================
+void VoiceBank::setSpatialLayout (SpatialEncoder::Layout newLayout)
+{
+    layout = newLayout;
+    std::fill (gainsDirty, gainsDirty + maxVoices, (uint8) 1);
+}
+
+void VoiceBank::setChannelPosition (int midiChannel, float newAzimuth, float newElevation)
+{
+    jassert (midiChannel > 0 && midiChannel <= 16);
+    channelAzimuth[midiChannel - 1] = newAzimuth;
+    channelElevation[midiChannel - 1] = newElevation;
+}
+
+void VoiceBank::setVoicePosition (int index, float newAzimuth, float newElevation)
+{
+    azimuth[index] = newAzimuth;
+    elevation[index] = newElevation;
+    gainsDirty[index] = 1;
+}
+
+void VoiceBank::updateGains() noexcept
+{
+    // at most once per voice per render, and only for voices that moved
+    for (int i = 0; i < numVoices; ++i)
+    {
+        if (gainsDirty[i] && active[i])
+        {
+            SpatialEncoder::computeGains (layout, azimuth[i], elevation[i], gains + i * gainStride);
+            gainsDirty[i] = 0;
+        }
+    }
+}
+
+//==============================================================================
+void VoiceBank::render (AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    if (numActive == 0)
+        return;
+
+    if (isSpatial())
+    {
+        renderSpatial (outputBuffer, startSample, numSamples);
+        return;
+    }
+
+    int groups[maxGroups];
+    const int numGroups = getActiveGroups (groups);
+
+    while (numSamples > 0)
+    {
+        const int numThisTime = jmin (numSamples, (int) chunkSize);
+
+        renderGroups (groups, numGroups, mix, numThisTime, accumulator);
+
+        for (int channel = 0; channel < outputBuffer.getNumChannels(); ++channel)
+            FloatVectorOperations::add (outputBuffer.getWritePointer (channel, startSample), mix, numThisTime);
+
+        startSample += numThisTime;
+        numSamples -= numThisTime;
+    }
+}
+
+int VoiceBank::getActiveGroups (int* groups) const noexcept
+{
+    const int numGroups = (numVoices + laneWidth - 1) / laneWidth;
+    int numFound = 0;
+
+    for (int group = 0; group < numGroups; ++group)
+        if (activeInGroup[group] > 0)
+            groups[numFound++] = group;
+
+    return numFound;
+}
+
+void VoiceBank::renderGroups (const int* groups, int numGroups, float* destination, int numSamples, float* tile) noexcept
+{
+    while (numSamples > 0)
+    {
+        const int numThisTime = jmin (numSamples, (int) chunkSize);
+
+        std::fill (tile, tile + numThisTime * laneWidth, 0.0f);
+
+        for (int i = 0; i < numGroups; ++i)
+            renderGroup (groups[i], tile, numThisTime);
+
+        // fold the lanes down to one mono signal
+        for (int sample = 0; sample < numThisTime; ++sample)
+        {
+            const float* lanes = tile + sample * laneWidth;
+            float sum = 0.0f;
+
+            for (int lane = 0; lane < laneWidth; ++lane)
+                sum += lanes[lane];
+
+            destination[sample] = sum;
+        }
+
+        destination += numThisTime;
+        numSamples -= numThisTime;
+    }
+}
+
+void VoiceBank::renderSpatial (AudioBuffer<float>& outputBuffer, int startSample, int numSamples) noexcept
+{
+    updateGains();
+
+    int groups[maxGroups];
+    const int numGroups = getActiveGroups (groups);
+    const int numChannels = jmin (outputBuffer.getNumChannels(), SpatialEncoder::getNumChannels (layout));
+
+    while (numSamples > 0)
+    {
+        const int numThisTime = jmin (numSamples, (int) chunkSize);
+
+        std::fill (spatialMix, spatialMix + numChannels * chunkSize, 0.0f);
+
+        for (int i = 0; i < numGroups; ++i)
+        {
+            std::fill (accumulator, accumulator + numThisTime * laneWidth, 0.0f);
+            renderGroup (groups[i], accumulator, numThisTime);
+
+            // one row of samples per voice, so the mix below runs along contiguous samples
+            for (int lane = 0; lane < laneWidth; ++lane)
+                for (int sample = 0; sample < numThisTime; ++sample)
+                    voiceRows[lane][sample] = accumulator[sample * laneWidth + lane];
+
+            const float* groupGains = gains + groups[i] * laneWidth * gainStride;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                float g[laneWidth];
+
+                for (int lane = 0; lane < laneWidth; ++lane)
+                    g[lane] = groupGains[lane * gainStride + channel];
+
+                float* dest = spatialMix + channel * chunkSize;
+
+                for (int sample = 0; sample < numThisTime; ++sample)
+                {
+                    float sum = 0.0f;
+
+                    for (int lane = 0; lane < laneWidth; ++lane)
+                        sum += g[lane] * voiceRows[lane][sample];
+
+                    dest[sample] += sum;
+                }
+            }
+        }
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            FloatVectorOperations::add (outputBuffer.getWritePointer (channel, startSample),
+                                        spatialMix + channel * chunkSize, numThisTime);
+
+        startSample += numThisTime;
+        numSamples -= numThisTime;
+    }
+}
+
+void VoiceBank::renderGroup (int group, float* tile, int numSamples) noexcept
+{
+    const int first = group * laneWidth;
+
+    if (voiceType == fmVoice)
+    {
+        renderFMGroup (first, tile, numSamples);
+        return;
+    }
+
+    // work on local copies so the compiler can keep a whole group in vector registers
+    uint32 p[laneWidth], inc[laneWidth];
+    float lvl[laneWidth], tgt[laneWidth], r[laneWidth];
+
+    for (int lane = 0; lane < laneWidth; ++lane)
+    {
+        p[lane]   = phase[first + lane];
+        inc[lane] = increment[first + lane];
+        lvl[lane] = level[first + lane];
+        tgt[lane] = target[first + lane];
+        r[lane]   = rate[first + lane];
+    }
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        float* out = tile + sample * laneWidth;
+
+        for (int lane = 0; lane < laneWidth; ++lane)
+        {
+            lvl[lane] += (tgt[lane] - lvl[lane]) * r[lane];
+            // read as signed the accumulator is -0.5 to 0.5 cycles, which the sine takes as it is
+            out[lane] += maxiFastMath::sinCycle ((float) (int32) p[lane] * (1.0f / 4294967296.0f)) * lvl[lane];
+            p[lane] += inc[lane];
+        }
+    }
+
+    for (int lane = 0; lane < laneWidth; ++lane)
+    {
+        phase[first + lane] = p[lane];
+        level[first + lane] = lvl[lane];
+    }
+}
+
+void VoiceBank::renderFMGroup (int first, float* tile, int numSamples) noexcept
+{
+    // on the stack, different threads render different groups at the same time
+    alignas (16) float voices[tileSize];
+    fm.renderGroup (first, voices, numSamples);
+
+    // the operator envelopes shape the note, the bank's envelope only keeps running so a note
+    // switched back to sineVoice carries on from where it would have been
+    float lvl[laneWidth], tgt[laneWidth], r[laneWidth], gain[laneWidth];
+
+    for (int lane = 0; lane < laneWidth; ++lane)
+    {
+        lvl[lane]  = level[first + lane];
+        tgt[lane]  = target[first + lane];
+        r[lane]    = rate[first + lane];
+        gain[lane] = velocity[first + lane];
+    }
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        float* out = tile + sample * laneWidth;
+        const float* in = voices + sample * laneWidth;
+
+        for (int lane = 0; lane < laneWidth; ++lane)
+        {
+            lvl[lane] += (tgt[lane] - lvl[lane]) * r[lane];
+            out[lane] += in[lane] * gain[lane];
+        }
+    }
+
+    for (int lane = 0; lane < laneWidth; ++lane)
+        level[first + lane] = lvl[lane];
+}
@@ -0,0 +1,163 @@
+/*
+  ==============================================================================
+
+    VoiceBank.h
+    Created: 17 Oct 2026 10:12:04am
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "SpatialEncoder.h"
+#include "FMEngine.h"
+
+//==============================================================================
+/**
+    Oscillator and envelope state for every voice of the synth, stored as
+    structure-of-arrays so that one loop advances laneWidth voices at a time.
+
+    SynthVoice objects only hold an index into the bank; PolySynth renders the
+    whole bank in one go from renderVoices().
+*/
+class VoiceBank
+{
+public:
+    static constexpr int maxVoices = 256;
+    static constexpr int laneWidth = 8;     // voices advanced together by the inner loop
+    static constexpr int chunkSize = 64;    // samples rendered per pass over the bank
+    static constexpr float silenceThreshold = 1.0e-4f;  // -80dB, a released voice below this is finished
+
+    enum VoiceType
+    {
+        sineVoice = 0,
+        fmVoice         // six operators, see FMEngine
+    };
+
+    VoiceBank();
+
+    void setSampleRate (double newSampleRate);
+
+    /** One pole attack and release time constants, applied to notes started or released after the call.
+        Only sineVoice uses them, fmVoice notes are shaped by their operator envelopes alone.
+    */
+    void setEnvelope (float newAttackSeconds, float newReleaseSeconds);
+
+    /** Switches every voice over, sounding notes included, and can be called at any time on the
+        audio thread. Every note starts and releases its FM operators, but only the type that's
+        playing is rendered, so a note switched to fmVoice partway through starts its FM
+        envelopes from the beginning of their attack (or release, if it has been let go).
+        A released fmVoice note ends once the operators that are heard have faded, however
+        long or short the bank's own release is.
+    */
+    void setVoiceType (VoiceType newType) noexcept  { voiceType = newType; }
+    VoiceType getVoiceType() const noexcept         { return voiceType; }
+
+    /** The operators, routing and envelopes used by fmVoice, see FMEngine::setPatch. */
+    void setFMPatch (const FMEngine::Patch& newPatch)   { fm.setPatch (newPatch); }
+    void setFMPatch (const FMEngine::CompiledPatch& newPatch) noexcept  { fm.setPatch (newPatch); }
+
+    void setNumVoices (int newNumVoices);
+    int getNumVoices() const noexcept               { return numVoices; }
+
+    void startVoice (int index, double frequency, float velocity, int midiChannel = 1);
+    void stopVoice (int index);
+
+    /** Lets the voice fade out, it stays active until retireSilentVoices() finds it below silenceThreshold. */
+    void releaseVoice (int index);
+
+    /** The longest a released voice can take to fall from full level to silenceThreshold. */
+    double getTailSeconds() const noexcept;
+
+    /** Stops every released voice that has decayed below silenceThreshold, returns how many it stopped. */
+    int retireSilentVoices() noexcept;
+
+    bool isVoiceActive (int index) const noexcept   { return active[index] != 0; }
+    bool isVoiceReleasing (int index) const noexcept { return releasing[index] != 0; }
+    float getLevel (int index) const noexcept       { return level[index]; }
+    float getTarget (int index) const noexcept      { return target[index]; }
+    uint32 getStartOrder (int index) const noexcept { return startOrder[index]; }
+
+    /** The start order the next startVoice() will give, voices at or above it haven't started yet. */
+    uint32 getNextStartOrder() const noexcept       { return nextStartOrder; }
+    int getNumActiveVoices() const noexcept         { return numActive; }
+
+    /** Adds every active voice into the buffer. With no spatial layout each voice goes
+        to all channels unchanged, otherwise it is panned or encoded by its position.
+    */
+    void render (AudioBuffer<float>& outputBuffer, int startSample, int numSamples);
+
+    //==============================================================================
+    void setSpatialLayout (SpatialEncoder::Layout newLayout);
+    bool isSpatial() const noexcept                 { return layout != SpatialEncoder::none; }
+
+    /** Position new notes on this MIDI channel start at, angles in radians. */
+    void setChannelPosition (int midiChannel, float azimuth, float elevation);
+
+    /** Moves a sounding voice, its gains are recomputed at the start of the next render. */
+    void setVoicePosition (int index, float azimuth, float elevation);
+
+    //==============================================================================
+    static constexpr int maxGroups = maxVoices / laneWidth;
+    static constexpr int tileSize = chunkSize * laneWidth;
+
+    /** Fills groups with the index of every group that has an active voice, returns how many. */
+    int getActiveGroups (int* groups) const noexcept;
+
+    /** Renders the mono mix of the listed groups into destination, overwriting it.
+        tile is tileSize floats of scratch space owned by the caller, so different
+        threads can render disjoint sets of groups at the same time.
+    */
+    void renderGroups (const int* groups, int numGroups, float* destination, int numSamples, float* tile) noexcept;
+
+private:
+    void renderGroup (int group, float* tile, int numSamples) noexcept;
+    void renderFMGroup (int first, float* tile, int numSamples) noexcept;
+    void renderSpatial (AudioBuffer<float>& outputBuffer, int startSample, int numSamples) noexcept;
+    void updateGains() noexcept;
+
+    void updateCoefficients();
+
+    double sampleRate = 44100.0;
+    float attackSeconds = 0.005f, releaseSeconds = 0.1f;
+    float attackCoefficient = 0.0f;
+    float releaseCoefficient = 0.0f;
+
+    VoiceType voiceType = sineVoice;
+    FMEngine fm;
+
+    int numVoices = 0;
+    int numActive = 0;
+    uint32 nextStartOrder = 0;
+
+    // per voice state, one entry per voice. Phases are 32 bit accumulators that wrap once per cycle,
+    // see maxiFixedPointOsc, so held notes never drift
+    alignas (16) uint32 phase[maxVoices];
+    alignas (16) uint32 increment[maxVoices];
+    alignas (16) float level[maxVoices];
+    alignas (16) float target[maxVoices];
+    alignas (16) float velocity[maxVoices];     // fmVoice gain, the operators do the envelope
+    alignas (16) float rate[maxVoices];
+    uint32 startOrder[maxVoices];
+    uint8 active[maxVoices];
+    uint8 releasing[maxVoices];
+    int activeInGroup[maxGroups];
+
+    // spatial position and output gains, gains are stored voice by voice with one
+    // entry per output channel so the mixing loop runs across channels
+    static constexpr int gainStride = SpatialEncoder::maxChannels;
+    SpatialEncoder::Layout layout = SpatialEncoder::none;
+    float azimuth[maxVoices], elevation[maxVoices];
+    float channelAzimuth[16], channelElevation[16];
+    uint8 gainsDirty[maxVoices];
+    alignas (16) float gains[maxVoices * gainStride];
+
+    // lane accumulators for one chunk, interleaved as [sample][lane]
+    alignas (16) float accumulator[tileSize];
+    alignas (16) float mix[chunkSize];
+    alignas (16) float voiceRows[laneWidth][chunkSize];      // one group's tile, transposed
+    alignas (16) float spatialMix[gainStride * chunkSize];   // [channel][sample]
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VoiceBank)
+};
@@ -0,0 +1,219 @@
+/*
+  ==============================================================================
+
+    VoiceRenderPool.cpp
+    Created: 17 Oct 2026 11:58:20am
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "VoiceRenderPool.h"
+#include <thread>
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+namespace
+{
+    // about 30 microseconds of pauses, longer than the gap between two slices of a block
+    constexpr int workerSpins = 1000;
+    constexpr int renderSpinsBeforeYield = 1000;
+    constexpr uint32 participantMask = 31;
+
+    // tells the core this is a spin loop, so it can give the other hyperthread the pipeline
+    inline void spinPause() noexcept
+    {
+       #if JUCE_INTEL
+        _mm_pause();
+       #elif JUCE_ARM && ! JUCE_MSVC
+        __asm__ __volatile__ ("yield");
+       #else
+        std::this_thread::yield();
+       #endif
+    }
+}
+
+//==============================================================================
+VoiceRenderPool::Worker::Worker (WorkerSet& owner, int participantIndex)
+    : Thread ("Voice render " + String (participantIndex)),
+      set (owner),
+      participant (participantIndex)
+{
+}
+
+VoiceRenderPool::Worker::~Worker()
+{
+    signalThreadShouldExit();
+    startEvent.signal();
+    stopThread (1000);
+}
+
+void VoiceRenderPool::Worker::run()
+{
+    uint32 seen = set.round.load (std::memory_order_acquire);
+
+    for (;;)
+    {
+        uint32 current = set.round.load (std::memory_order_acquire);
+
+        for (int spins = 0; current == seen && spins < workerSpins; ++spins)
+        {
+            spinPause();
+            current = set.round.load (std::memory_order_acquire);
+        }
+
+        if (current == seen)
+        {
+            // render() only signals sleeping workers. Either it sees the flag or this sees
+            // its new round, so a round can't be missed.
+            sleeping.store (true, std::memory_order_seq_cst);
+
+            if (set.round.load (std::memory_order_seq_cst) == seen && ! threadShouldExit())
+                startEvent.wait (-1);
+
+            sleeping.store (false, std::memory_order_relaxed);
+
+            if (threadShouldExit())
+                return;
+
+            continue;
+        }
+
+        seen = current;
+
+        if (participant < (int) (current & participantMask))
+        {
+            set.renderJob (participant);
+            set.pending.fetch_sub (1, std::memory_order_release);
+        }
+    }
+}
+
+//==============================================================================
+VoiceRenderPool::WorkerSet::WorkerSet (VoiceBank& bankToRender, int numThreads)
+    : bank (bankToRender)
+{
+    const int numParticipants = numThreads + 1;
+    buffers.calloc ((size_t) (numParticipants * sliceSize));
+    tiles.calloc ((size_t) (numParticipants * VoiceBank::tileSize));
+
+    for (int i = 1; i < numParticipants; ++i)
+        workers.add (new Worker (*this, i))->startThread (Thread::realtimeAudioPriority);
+}
+
+VoiceRenderPool::WorkerSet::~WorkerSet()
+{
+    // the threads go before the buffers they render into
+    workers.clear();
+}
+
+void VoiceRenderPool::WorkerSet::renderJob (int participant) noexcept
+{
+    const Job& job = jobs[participant];
+
+    bank.renderGroups (job.groups, job.numGroups,
+                       buffers + participant * sliceSize, job.numSamples,
+                       tiles + participant * VoiceBank::tileSize);
+}
+
+//==============================================================================
+VoiceRenderPool::VoiceRenderPool (VoiceBank& bankToRender)
+    : bank (bankToRender)
+{
+}
+
+VoiceRenderPool::~VoiceRenderPool()
+{
+    workerSet.reset();
+}
+
+void VoiceRenderPool::setNumThreads (int numThreads, const CriticalSection& renderLock)
+{
+    numThreads = jlimit (0, (int) maxThreads, numThreads);
+
+    if (numThreads == getNumThreads())
+        return;
+
+    // the new workers start idle, nothing hands them a round until they're swapped in
+    std::unique_ptr<WorkerSet> newSet;
+
+    if (numThreads > 0)
+        newSet.reset (new WorkerSet (bank, numThreads));
+
+    {
+        const ScopedLock sl (renderLock);
+        std::swap (workerSet, newSet);
+    }
+
+    // and the old ones are stopped here, after render() has stopped using them
+}
+
+//==============================================================================
+void VoiceRenderPool::render (AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    if (bank.getNumActiveVoices() == 0)
+        return;
+
+    int groups[VoiceBank::maxGroups];
+    const int numGroups = bank.getActiveGroups (groups);
+    const int numParticipants = jmin (getNumThreads() + 1, numGroups);
+
+    if (numParticipants < 2)
+    {
+        bank.render (outputBuffer, startSample, numSamples);
+        return;
+    }
+
+    auto& set = *workerSet;
+
+    while (numSamples > 0)
+    {
+        const int numThisTime = jmin (numSamples, (int) sliceSize);
+
+        // contiguous runs of active groups, the same split every time for the same voices
+        for (int i = 0; i < numParticipants; ++i)
+        {
+            const int first = numGroups * i / numParticipants;
+            const int last  = numGroups * (i + 1) / numParticipants;
+
+            set.jobs[i].groups = groups + first;
+            set.jobs[i].numGroups = last - first;
+            set.jobs[i].numSamples = numThisTime;
+        }
+
+        set.pending.store (numParticipants - 1, std::memory_order_relaxed);
+        set.round.store ((++set.roundNumber << 5) | (uint32) numParticipants, std::memory_order_seq_cst);
+
+        for (int i = 1; i < numParticipants; ++i)
+        {
+            auto* worker = set.workers.getUnchecked (i - 1);
+
+            if (worker->sleeping.load (std::memory_order_seq_cst))
+                worker->startEvent.signal();
+        }
+
+        set.renderJob (0);
+
+        for (int spins = 0; set.pending.load (std::memory_order_acquire) > 0; ++spins)
+        {
+            if (spins < renderSpinsBeforeYield)
+                spinPause();
+            else
+                std::this_thread::yield();
+        }
+
+        // fixed summing order keeps the result independent of thread timing
+        float* mix = set.buffers.get();
+
+        for (int i = 1; i < numParticipants; ++i)
+            FloatVectorOperations::add (mix, set.buffers + i * sliceSize, numThisTime);
+
+        for (int channel = 0; channel < outputBuffer.getNumChannels(); ++channel)
+            FloatVectorOperations::add (outputBuffer.getWritePointer (channel, startSample), mix, numThisTime);
+
+        startSample += numThisTime;
+        numSamples -= numThisTime;
+    }
+}
@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+
+    VoiceRenderPool.h
+    Created: 17 Oct 2026 11:58:20am
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "VoiceBank.h"
+
+//==============================================================================
+/**
+    Splits the active voice groups of a VoiceBank across a fixed set of
+    pre-spawned worker threads.
+
+    The calling (audio) thread takes the first share itself, hands the rest to
+    the workers by bumping an atomic round number and spins until they are
+    done. Workers spin on the round for a little while after each job, so the
+    slices of a block follow each other without a wake up, and only then sleep
+    on their event. Every participant renders into
+    its own buffer and the buffers are summed in participant order, and the
+    split only depends on which groups are active, so the output is
+    bit-identical to another run with the same input no matter how the
+    threads happen to be scheduled.
+
+    setNumThreads() starts and stops threads so it must not be called from the
+    audio thread. It builds the new set of workers beside the old one and only
+    holds the render lock to swap them over, so render() never waits for a
+    thread to start or stop. render() doesn't allocate, and only locks to
+    signal the event of a worker that has gone to sleep, at most once per
+    worker per block.
+*/
+class VoiceRenderPool
+{
+public:
+    static constexpr int maxThreads = 16;
+    static constexpr int sliceSize = 1024;  // samples handed out per round trip
+
+    explicit VoiceRenderPool (VoiceBank& bankToRender);
+    ~VoiceRenderPool();
+
+    /** Number of worker threads besides the audio thread, 0 turns the pool off.
+        renderLock is the lock render() is called under, it's only held while the new
+        workers replace the old ones.
+    */
+    void setNumThreads (int numThreads, const CriticalSection& renderLock);
+    int getNumThreads() const noexcept          { return workerSet != nullptr ? workerSet->workers.size() : 0; }
+
+    /** Adds every active voice into all channels of the buffer, like VoiceBank::render(). */
+    void render (AudioBuffer<float>& outputBuffer, int startSample, int numSamples);
+
+private:
+    //==============================================================================
+    struct Job
+    {
+        const int* groups = nullptr;
+        int numGroups = 0;
+        int numSamples = 0;
+    };
+
+    struct WorkerSet;
+
+    class Worker : public Thread
+    {
+    public:
+        Worker (WorkerSet& owner, int participantIndex);
+        ~Worker();
+
+        void run() override;
+
+        WaitableEvent startEvent;
+        std::atomic<bool> sleeping { false };
+
+    private:
+        WorkerSet& set;
+        const int participant;
+    };
+
+    // everything the workers share with render(), a new set is built whenever the thread count changes
+    struct WorkerSet
+    {
+        WorkerSet (VoiceBank& bankToRender, int numThreads);
+        ~WorkerSet();
+
+        void renderJob (int participant) noexcept;
+
+        VoiceBank& bank;
+        OwnedArray<Worker> workers;
+
+        // one entry per participant, index 0 is the calling thread
+        Job jobs[maxThreads + 1];
+        HeapBlock<float> buffers, tiles;
+        std::atomic<int> pending { 0 };
+
+        // the round of jobs that's up and how many participants it has, packed into one value
+        // (round * 32 + count) so a worker always reads the two together
+        std::atomic<uint32> round { 0 };
+        uint32 roundNumber = 0;
+    };
+
+    VoiceBank& bank;
+    std::unique_ptr<WorkerSet> workerSet;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VoiceRenderPool)
+};
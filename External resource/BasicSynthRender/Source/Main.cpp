@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    This file was auto-generated!
+
+    It contains the basic startup code for a JUCE application.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "OfflineRenderer.h"
+
+//==============================================================================
+static void printUsage()
+{
+    std::cout << "Renders Standard MIDI Files through BasicSynth to WAV, faster than real time." << std::endl
+              << std::endl
+              << "  BasicSynthRender [options] input.mid output.wav" << std::endl
+              << "  BasicSynthRender --batch=<output folder> [options] input1.mid input2.mid ..." << std::endl
+              << std::endl
+              << "Options:" << std::endl
+              << "  --rate=<Hz>          sample rate (48000)" << std::endl
+              << "  --block=<samples>    processBlock size (512)" << std::endl
+              << "  --bits=<16|24|32>    WAV bit depth (24)" << std::endl
+              << "  --tail=<seconds>     extra time after the last event (2)" << std::endl
+              << "  --polyphony=<voices> number of voices (32)" << std::endl
+              << "  --threads=<n>        files rendered at once in batch mode (one per CPU)" << std::endl;
+}
+
+int main (int argc, char* argv[])
+{
+    ScopedJuceInitialiser_GUI juceInitialiser;
+    ArgumentList args (argc, argv);
+
+    if (args.size() == 0 || args.containsOption ("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    OfflineRenderer::Settings settings;
+
+    auto intOption = [&args] (const char* option, int defaultValue)
+    {
+        auto value = args.getValueForOption (option);
+        return value.isEmpty() ? defaultValue : value.getIntValue();
+    };
+
+    settings.sampleRate = (double) intOption ("--rate", (int) settings.sampleRate);
+    settings.blockSize  = intOption ("--block", settings.blockSize);
+    settings.bitDepth   = intOption ("--bits", settings.bitDepth);
+    settings.polyphony  = intOption ("--polyphony", settings.polyphony);
+
+    if (args.containsOption ("--tail"))
+        settings.tailSeconds = args.getValueForOption ("--tail").getDoubleValue();
+
+    if (settings.sampleRate <= 0.0 || settings.blockSize <= 0 || settings.tailSeconds < 0.0)
+    {
+        std::cerr << "Sample rate and block size must be positive and the tail can't be negative" << std::endl;
+        return 1;
+    }
+
+    Array<File> files;
+
+    for (auto& arg : args.arguments)
+        if (! arg.isOption())
+            files.add (arg.resolveAsFile());
+
+    OfflineRenderer renderer (settings);
+
+    if (args.containsOption ("--batch"))
+    {
+        auto outputFolder = File::getCurrentWorkingDirectory().getChildFile (args.getValueForOption ("--batch"));
+        const int numThreads = intOption ("--threads", SystemStats::getNumCpus());
+
+        return renderer.renderBatch (files, outputFolder, numThreads) == 0 ? 0 : 1;
+    }
+
+    if (files.size() != 2)
+    {
+        printUsage();
+        return 1;
+    }
+
+    auto result = renderer.render (files[0], files[1]);
+
+    if (result.failed())
+    {
+        std::cerr << result.getErrorMessage() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,171 @@
+/*
+  ==============================================================================
+
+    OfflineRenderer.cpp
+    Created: 17 Oct 2026 1:05:37pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#include "OfflineRenderer.h"
+#include "../../BasicSynthPlugin/Source/PluginProcessor.h"
+
+//==============================================================================
+OfflineRenderer::OfflineRenderer (const Settings& settingsToUse)
+    : settings (settingsToUse)
+{
+}
+
+Result OfflineRenderer::readMidiFile (const File& midiFile, MidiMessageSequence& sequence)
+{
+    FileInputStream stream (midiFile);
+
+    if (stream.failedToOpen())
+        return Result::fail ("Couldn't open " + midiFile.getFullPathName());
+
+    MidiFile file;
+
+    if (! file.readFrom (stream))
+        return Result::fail (midiFile.getFullPathName() + " isn't a valid MIDI file");
+
+    file.convertTimestampTicksToSeconds();
+
+    // every track goes through the one synth, addSequence keeps the result sorted
+    for (int i = 0; i < file.getNumTracks(); ++i)
+        sequence.addSequence (*file.getTrack (i), 0.0);
+
+    return Result::ok();
+}
+
+Result OfflineRenderer::render (const File& midiFile, const File& wavFile) const
+{
+    MidiMessageSequence sequence;
+    auto result = readMidiFile (midiFile, sequence);
+
+    if (result.failed())
+        return result;
+
+    BasicSynthAudioProcessor processor;
+    const int numChannels = processor.getTotalNumOutputChannels();
+
+    processor.setPolyphony (settings.polyphony);
+    processor.setNonRealtime (true);
+    processor.setPlayConfigDetails (0, numChannels, settings.sampleRate, settings.blockSize);
+    processor.prepareToPlay (settings.sampleRate, settings.blockSize);
+
+    wavFile.deleteFile();
+    std::unique_ptr<FileOutputStream> stream (wavFile.createOutputStream());
+
+    if (stream == nullptr)
+        return Result::fail ("Couldn't write to " + wavFile.getFullPathName());
+
+    WavAudioFormat wavFormat;
+    std::unique_ptr<AudioFormatWriter> writer (wavFormat.createWriterFor (stream.get(), settings.sampleRate,
+                                                                          (unsigned int) numChannels,
+                                                                          settings.bitDepth, {}, 0));
+    if (writer == nullptr)
+        return Result::fail ("Can't write a " + String (settings.bitDepth) + " bit WAV file");
+
+    stream.release(); // the writer owns it now
+
+    AudioBuffer<float> buffer (numChannels, settings.blockSize);
+    MidiBuffer midi;
+
+    const int64 totalSamples = (int64) std::ceil ((sequence.getEndTime() + settings.tailSeconds) * settings.sampleRate);
+    int nextEvent = 0;
+
+    for (int64 blockStart = 0; blockStart < totalSamples; blockStart += settings.blockSize)
+    {
+        midi.clear();
+
+        for (; nextEvent < sequence.getNumEvents(); ++nextEvent)
+        {
+            const auto& message = sequence.getEventPointer (nextEvent)->message;
+            const int64 position = (int64) (message.getTimeStamp() * settings.sampleRate);
+
+            if (position >= blockStart + settings.blockSize)
+                break;
+
+            if (! message.isMetaEvent())
+                midi.addEvent (message, (int) jmax ((int64) 0, position - blockStart));
+        }
+
+        processor.processBlock (buffer, midi);
+
+        // the last block is rendered in full but only written up to the end of the tail
+        const int numToWrite = (int) jmin ((int64) settings.blockSize, totalSamples - blockStart);
+
+        if (! writer->writeFromAudioSampleBuffer (buffer, 0, numToWrite))
+            return Result::fail ("Error writing " + wavFile.getFullPathName());
+    }
+
+    processor.releaseResources();
+    return Result::ok();
+}
+
+//==============================================================================
+namespace
+{
+    class RenderJob : public ThreadPoolJob
+    {
+    public:
+        RenderJob (const OfflineRenderer& rendererToUse, const File& midi, const File& wav)
+            : ThreadPoolJob ("Render " + midi.getFileName()),
+              renderer (rendererToUse), midiFile (midi), wavFile (wav)
+        {
+        }
+
+        JobStatus runJob() override
+        {
+            const double startTime = Time::getMillisecondCounterHiRes();
+            result = renderer.render (midiFile, wavFile);
+            seconds = (Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+            return jobHasFinished;
+        }
+
+        const OfflineRenderer& renderer;
+        const File midiFile, wavFile;
+        Result result { Result::ok() };
+        double seconds = 0.0;
+    };
+}
+
+int OfflineRenderer::renderBatch (const Array<File>& midiFiles, const File& outputFolder, int numThreads) const
+{
+    if (! outputFolder.createDirectory())
+    {
+        std::cerr << "Couldn't create " << outputFolder.getFullPathName() << std::endl;
+        return midiFiles.size();
+    }
+
+    ThreadPool pool (jmax (1, numThreads));
+    OwnedArray<RenderJob> jobs;
+
+    for (auto& midiFile : midiFiles)
+    {
+        auto wavFile = outputFolder.getChildFile (midiFile.getFileNameWithoutExtension() + ".wav");
+        pool.addJob (jobs.add (new RenderJob (*this, midiFile, wavFile)), false);
+    }
+
+    int numFailed = 0;
+
+    // wait in submission order so the report comes out in the same order as the arguments
+    for (auto* job : jobs)
+    {
+        pool.waitForJobToFinish (job, -1);
+
+        if (job->result.failed())
+        {
+            std::cerr << job->midiFile.getFileName() << ": " << job->result.getErrorMessage() << std::endl;
+            ++numFailed;
+        }
+        else
+        {
+            std::cout << job->midiFile.getFileName() << " -> " << job->wavFile.getFullPathName()
+                      << " (" << String (job->seconds, 2) << "s)" << std::endl;
+        }
+    }
+
+    return numFailed;
+}
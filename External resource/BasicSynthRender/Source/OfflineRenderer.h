@@ -0,0 +1,51 @@
+/*
+  ==============================================================================
+
+    OfflineRenderer.h
+    Created: 17 Oct 2026 1:05:37pm
+    Author:  Chris
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Plays Standard MIDI Files through BasicSynthAudioProcessor and writes the
+    result to WAV files, as fast as the processor will go.
+
+    Every render makes its own processor, so render() can be called from
+    several threads at once and renderBatch() simply runs one render per
+    thread.
+*/
+class OfflineRenderer
+{
+public:
+    struct Settings
+    {
+        double sampleRate = 48000.0;
+        int blockSize = 512;
+        int bitDepth = 24;
+        double tailSeconds = 2.0;   // rendered after the last MIDI event so releases can finish
+        int polyphony = 32;
+    };
+
+    explicit OfflineRenderer (const Settings& settingsToUse);
+
+    /** Renders one MIDI file into a WAV file, replacing it if it exists. */
+    Result render (const File& midiFile, const File& wavFile) const;
+
+    /** Renders each MIDI file to outputFolder/<name>.wav on numThreads threads,
+        prints a line per file and returns how many failed.
+    */
+    int renderBatch (const Array<File>& midiFiles, const File& outputFolder, int numThreads) const;
+
+private:
+    static Result readMidiFile (const File& midiFile, MidiMessageSequence& sequence);
+
+    const Settings settings;
+
+    JUCE_DECLARE_NON_COPYABLE (OfflineRenderer)
+};